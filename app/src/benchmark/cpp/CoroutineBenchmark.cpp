@@ -0,0 +1,197 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <coroutine/FramePool.hpp>
+#include <coroutine/FuturePromise.hpp>
+#include <coroutine/Oneshot.hpp>
+
+namespace kl::benchmark {
+    using kl::coroutine::Oneshot;
+
+    /* one thread resuming posted coroutines, the same for both result channels */
+    class Handoff final {
+    public:
+        Handoff() : stopped(false), thread(&Handoff::run, this) {}
+
+        ~Handoff() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+            }
+
+            condition.notify_one();
+            thread.join();
+        }
+
+        auto schedule() noexcept {
+            struct Awaitable final {
+                bool await_ready() const noexcept { return false; }
+                void await_resume() const noexcept {}
+                void await_suspend(std::experimental::coroutine_handle<> handle) {
+                    {
+                        std::lock_guard<std::mutex> lock(handoff.mutex);
+                        handoff.handles.push_back(handle);
+                    }
+
+                    handoff.condition.notify_one();
+                }
+
+                Handoff& handoff;
+            };
+
+            return Awaitable{*this};
+        }
+
+    private:
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (true) {
+                condition.wait(lock, [this] { return stopped || !handles.empty(); });
+
+                if (handles.empty()) {
+                    break;
+                }
+
+                auto handle = handles.front();
+                handles.pop_front();
+                lock.unlock();
+                handle.resume();
+                lock.lock();
+            }
+        }
+
+        bool stopped;
+        std::deque<std::experimental::coroutine_handle<>> handles;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::thread thread;
+    };
+
+    static std::future<int> inlineFuture(int value) {
+        co_return value + 1;
+    }
+
+    static Oneshot<int> inlineOneshot(int value) {
+        co_return value + 1;
+    }
+
+    static std::future<int> handoffFuture(Handoff& handoff, int value) {
+        co_await handoff.schedule();
+        co_return value + 1;
+    }
+
+    static Oneshot<int> handoffOneshot(Handoff& handoff, int value) {
+        co_await handoff.schedule();
+        co_return value + 1;
+    }
+
+    /* median time of one task in nanoseconds */
+    template<typename Run>
+    static double measure(int countTasks, int repeat, Run&& run) {
+        std::vector<double> samples;
+
+        for (int i = 0; i < repeat; ++i) {
+            long checksum = 0;
+            auto beginTime = std::chrono::steady_clock::now();
+
+            for (int task = 0; task < countTasks; ++task) {
+                checksum += run(task);
+            }
+
+            auto endTime = std::chrono::steady_clock::now();
+
+            if (checksum == 0) {
+                std::fprintf(stderr, "Wrong checksum\n");
+            }
+
+            samples.push_back(std::chrono::duration<double, std::nano>(endTime - beginTime).count() / countTasks);
+        }
+
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    static void run(int countTasks, int repeat) {
+        Handoff handoff;
+
+        const double inlineFutureTime = measure(countTasks, repeat, [](int task) { return inlineFuture(task).get(); });
+        const double inlineOneshotTime = measure(countTasks, repeat, [](int task) { return inlineOneshot(task).get(); });
+        const double handoffFutureTime = measure(countTasks, repeat, [&](int task) { return handoffFuture(handoff, task).get(); });
+        const double handoffOneshotTime = measure(countTasks, repeat, [&](int task) { return handoffOneshot(handoff, task).get(); });
+
+        /* the same oneshot coroutines with frames from operator new */
+        kl::coroutine::setFramePoolEnabled(false);
+
+        const double inlineNewTime = measure(countTasks, repeat, [](int task) { return inlineOneshot(task).get(); });
+        const double handoffNewTime = measure(countTasks, repeat, [&](int task) { return handoffOneshot(handoff, task).get(); });
+
+        kl::coroutine::setFramePoolEnabled(true);
+
+        std::printf("tasks: %d, repeat: %d\n\n", countTasks, repeat);
+        std::printf("%-10s %14s %14s %14s\n", "resume", "future ns", "oneshot ns", "new frame ns");
+        std::printf("%-10s %14.1f %14.1f %14.1f\n", "inline", inlineFutureTime, inlineOneshotTime, inlineNewTime);
+        std::printf("%-10s %14.1f %14.1f %14.1f\n", "thread", handoffFutureTime, handoffOneshotTime, handoffNewTime);
+    }
+
+    static void usage(const char* program) {
+        std::printf("Usage: %s [--tasks N] [--repeat N]\n"
+                    "  --tasks   coroutines of each case, default 1000000\n"
+                    "  --repeat  runs of each case, median is reported, default 5\n", program);
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace kl::benchmark;
+    int countTasks = 1000000;
+    int repeat = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--tasks" && hasValue) {
+            countTasks = std::max(std::atoi(argv[++i]), 1);
+        } else if (argument == "--repeat" && hasValue) {
+            repeat = std::max(std::atoi(argv[++i]), 1);
+        } else {
+            usage(argv[0]);
+            return argument == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    run(countTasks, repeat);
+
+    return EXIT_SUCCESS;
+}
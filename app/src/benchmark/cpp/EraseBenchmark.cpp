@@ -0,0 +1,440 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/statvfs.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fs/EraseSession.hpp>
+#include <fs/EraseProgress.hpp>
+#include <fs/FileUnit.hpp>
+
+namespace kl::benchmark {
+    using namespace kl::fs;
+    using fs::literals::operator""_kb;
+    using fs::literals::operator""_mb;
+    using fs::literals::operator""_gb;
+
+    static constexpr std::array<std::uintmax_t, 7> FILE_SIZES = {4_kb, 64_kb, 1_mb, 16_mb, 256_mb, 1_gb, 4_gb};
+    static constexpr std::array<std::uint32_t, 3> BUFFER_SIZES = {4_kb, 64_kb, 1_mb};
+    static constexpr std::size_t FILL_SIZE = 1_mb;
+
+    struct BenchmarkConfig final {
+        std::vector<std::filesystem::path> directories;
+        std::uintmax_t maxFileSize = 4_gb;
+        WriteBackend backend = WriteBackend::STDIO_BACKEND;
+        SyncPolicy syncPolicy = SyncPolicy::FILE_SYNC;
+        bool tune = false;
+        int threads = 1;
+        /* empty means every mode except GUTMANN_MODE, it takes 35 passes */
+        std::vector<OverwriteMode> modes;
+        int repeat = 3;
+    };
+
+    struct Measurement final {
+        double throughput;    /* MB/s */
+        double syscallsPerMb;
+        double passLatency;   /* ms */
+    };
+
+    /*
+     * Count syscalls of process with raw_syscalls:sys_enter tracepoint. When tracefs
+     * isn't accessible, read and write syscalls from /proc/self/io are counted instead.
+     */
+    class SyscallCounter final {
+    public:
+        SyscallCounter() : perfFd(-1), startCount(0) {
+            for (const char* idPath : {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+                                       "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"}) {
+                std::ifstream idFile(idPath);
+                std::uint64_t id = 0;
+
+                if (!(idFile >> id)) {
+                    continue;
+                }
+
+                perf_event_attr attributes = {};
+                attributes.type = PERF_TYPE_TRACEPOINT;
+                attributes.size = sizeof(attributes);
+                attributes.config = id;
+                attributes.disabled = 1;
+                attributes.inherit = 1;
+
+                perfFd = static_cast<int>(::syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+
+                if (perfFd != -1) {
+                    break;
+                }
+            }
+        }
+
+        ~SyscallCounter() {
+            if (perfFd != -1) {
+                ::close(perfFd);
+            }
+        }
+
+        SyscallCounter(const SyscallCounter&) = delete;
+        SyscallCounter& operator=(const SyscallCounter&) = delete;
+
+        const char* source() const {
+            return perfFd != -1 ? "all syscalls (tracepoint)" : "read/write syscalls (/proc/self/io)";
+        }
+
+        void start() {
+            if (perfFd != -1) {
+                ::ioctl(perfFd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(perfFd, PERF_EVENT_IOC_ENABLE, 0);
+            } else {
+                startCount = readProcIo();
+            }
+        }
+
+        std::uint64_t stop() {
+            if (perfFd != -1) {
+                std::uint64_t count = 0;
+                ::ioctl(perfFd, PERF_EVENT_IOC_DISABLE, 0);
+
+                if (::read(perfFd, &count, sizeof(count)) != sizeof(count)) {
+                    return 0;
+                }
+
+                return count;
+            }
+
+            return readProcIo() - startCount;
+        }
+
+    private:
+        static std::uint64_t readProcIo() {
+            std::ifstream io("/proc/self/io");
+            std::string key;
+            std::uint64_t value = 0;
+            std::uint64_t count = 0;
+
+            while (io >> key >> value) {
+                if (key == "syscr:" || key == "syscw:") {
+                    count += value;
+                }
+            }
+
+            return count;
+        }
+
+    private:
+        int perfFd;
+        std::uint64_t startCount;
+    };
+
+    static std::string formatSize(std::uintmax_t size) {
+        if (size >= 1_gb && size % 1_gb == 0) {
+            return std::to_string(size / 1_gb) + "G";
+        }
+
+        if (size >= 1_mb && size % 1_mb == 0) {
+            return std::to_string(size / 1_mb) + "M";
+        }
+
+        if (size >= 1_kb && size % 1_kb == 0) {
+            return std::to_string(size / 1_kb) + "K";
+        }
+
+        return std::to_string(size);
+    }
+
+    static std::uintmax_t parseSize(const char* text) {
+        char* end = nullptr;
+        std::uintmax_t value = std::strtoumax(text, &end, 10);
+
+        switch (end != nullptr ? *end : '\0') {
+        case 'K': case 'k': return value * 1_kb;
+        case 'M': case 'm': return value * 1_mb;
+        case 'G': case 'g': return value * 1_gb;
+        default: return value;
+        }
+    }
+
+    static std::uintmax_t freeSpace(const std::filesystem::path& directory) {
+        struct statvfs info = {};
+
+        if (::statvfs(directory.c_str(), &info) == -1) {
+            return 0;
+        }
+
+        return static_cast<std::uintmax_t>(info.f_bavail) * info.f_frsize;
+    }
+
+    static Result<void, FileError> createFile(const std::filesystem::path& path, std::uintmax_t size) {
+        const int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0600);
+
+        if (fd == -1) {
+            return FileError("Can't create file %s, error %s", path.c_str(), ::strerror(errno));
+        }
+
+        std::vector<std::uint8_t> data(FILL_SIZE, 'x');
+        auto result = writePattern(fd, data.data(), data.size(), 0, size);
+
+        /* allocate blocks now, so erase doesn't pay for delayed allocation */
+        ::fsync(fd);
+        ::close(fd);
+
+        if (result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        return {};
+    }
+
+    static Result<Measurement, FileError> measure(const std::filesystem::path& path, std::uintmax_t fileSize,
+                                                  std::uint32_t bufferSize, OverwriteMode mode,
+                                                  const BenchmarkConfig& config, SyscallCounter& counter,
+                                                  BufferPool& pool, ChunkTuner& tuner) {
+        if (auto result = createFile(path, fileSize); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        EraseSession session(pool);
+        EraseProgress progress;
+
+        EraseOptions options;
+        options.backend = config.backend;
+        options.bufferSize = bufferSize;
+        options.progress = &progress;
+        options.syncPolicy = config.syncPolicy;
+        options.chunkTuner = &tuner;
+        options.rangeThreads = static_cast<std::uint32_t>(config.threads);
+        options.rangeThreshold = 0;
+
+        if (auto result = session.init(path, mode, options); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        if (auto result = session.prepareFile(); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        counter.start();
+        auto beginTime = std::chrono::steady_clock::now();
+
+        auto result = session.overwriteFile();
+
+        /* single file is its own batch */
+        if (!result.hasError() && (config.syncPolicy == SyncPolicy::FILE_SYNC ||
+                                   config.syncPolicy == SyncPolicy::BATCH_SYNC)) {
+            result = session.syncFile();
+        }
+
+        auto endTime = std::chrono::steady_clock::now();
+        const std::uint64_t countSyscalls = counter.stop();
+
+        session.closeFile();
+        std::filesystem::remove(path);
+
+        if (result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        /* DISCARD_MODE writes nothing, so rate is reported for discarded size */
+        const std::uintmax_t bytes = progress.countBytes.load() != 0 ? progress.countBytes.load() : fileSize;
+        const int countPasses = std::max<int>(OVERWRITE_MODE.ordinal(mode), 1);
+        const double seconds = std::chrono::duration<double>(endTime - beginTime).count();
+        const double megabytes = static_cast<double>(bytes) / 1_mb;
+
+        Measurement measurement = {};
+        measurement.throughput = seconds > 0.0 ? megabytes / seconds : 0.0;
+        measurement.syscallsPerMb = static_cast<double>(countSyscalls) / megabytes;
+        measurement.passLatency = seconds * 1000.0 / countPasses;
+
+        return measurement;
+    }
+
+    static void run(const BenchmarkConfig& config) {
+        SyscallCounter counter;
+        BufferPool pool(BUFFER_SIZES.size());
+        ChunkTuner tuner;
+
+        /* zero buffer size is chosen by tuner */
+        std::vector<std::uint32_t> bufferSizes(BUFFER_SIZES.begin(), BUFFER_SIZES.end());
+
+        if (config.tune) {
+            bufferSizes.push_back(0);
+        }
+
+        std::vector<OverwriteMode> modes = config.modes;
+
+        if (modes.empty()) {
+            for (OverwriteMode mode : OVERWRITE_MODE.values()) {
+                if (mode != OverwriteMode::GUTMANN_MODE) {
+                    modes.push_back(mode);
+                }
+            }
+        }
+
+        std::printf("backend: %s, sync: %s, threads: %d, repeat: %d, syscalls: %s\n\n",
+                    WRITE_BACKEND.name(config.backend), SYNC_POLICY.name(config.syncPolicy), config.threads,
+                    config.repeat, counter.source());
+        std::printf("%-16s %6s %6s %-13s %10s %12s %12s\n",
+                    "directory", "size", "buffer", "mode", "MB/s", "syscalls/MB", "pass ms");
+
+        for (const auto& directory : config.directories) {
+            const std::filesystem::path path = directory / "firearrow_benchmark.bin";
+
+            for (std::uintmax_t fileSize : FILE_SIZES) {
+                if (fileSize > config.maxFileSize) {
+                    continue;
+                }
+
+                if (fileSize > freeSpace(directory) / 2) {
+                    std::printf("%-16s %6s skipped, not enough free space\n", directory.c_str(),
+                                formatSize(fileSize).c_str());
+                    continue;
+                }
+
+                for (std::uint32_t bufferSize : bufferSizes) {
+                    if (bufferSize > fileSize && bufferSize != BUFFER_SIZES.front()) {
+                        continue;
+                    }
+
+                    for (OverwriteMode mode : modes) {
+                        std::vector<Measurement> samples;
+
+                        for (int i = 0; i < config.repeat; ++i) {
+                            auto result = measure(path, fileSize, bufferSize, mode, config, counter, pool, tuner);
+
+                            if (result.hasError()) {
+                                std::fprintf(stderr, "Fail benchmark: %s\n", result.error().message.get().c_str());
+                                break;
+                            }
+
+                            samples.push_back(result.value());
+                        }
+
+                        if (samples.empty()) {
+                            continue;
+                        }
+
+                        /* median by throughput */
+                        std::sort(samples.begin(), samples.end(), [](const auto& left, const auto& right) {
+                            return left.throughput < right.throughput;
+                        });
+                        const Measurement& median = samples[samples.size() / 2];
+
+                        std::printf("%-16s %6s %6s %-13s %10.1f %12.2f %12.3f\n", directory.c_str(),
+                                    formatSize(fileSize).c_str(),
+                                    bufferSize != 0 ? formatSize(bufferSize).c_str() : "auto",
+                                    OVERWRITE_MODE.name(mode), median.throughput,
+                                    median.syscallsPerMb, median.passLatency);
+                        std::fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+
+    static void usage(const char* program) {
+        std::printf("Usage: %s [--dir PATH]... [--max-size SIZE[K|M|G]] [--backend NAME] [--sync NAME] [--tune] [--threads N]\n"
+                    "          [--mode NAME]... [--repeat N]\n"
+                    "  --dir       directory of temporary files, default /dev/shm and /var/tmp\n"
+                    "  --max-size  largest file size of sweep, default 4G\n"
+                    "  --backend   STDIO_BACKEND, URING_BACKEND, DIRECT_BACKEND, MMAP_BACKEND or AUTO_BACKEND\n"
+                    "  --sync      NO_SYNC, PASS_SYNC, FILE_SYNC or BATCH_SYNC, default FILE_SYNC\n"
+                    "  --tune      add sweep of chunk size, which is calibrated per filesystem\n"
+                    "  --threads   threads writing ranges of one file with stdio backend, default 1\n"
+                    "  --mode      overwrite mode to measure, default all modes except GUTMANN_MODE\n"
+                    "  --repeat    runs of each case, median is reported, default 3\n", program);
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace kl::benchmark;
+    BenchmarkConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--dir" && hasValue) {
+            config.directories.emplace_back(argv[++i]);
+        } else if (argument == "--max-size" && hasValue) {
+            config.maxFileSize = parseSize(argv[++i]);
+        } else if (argument == "--backend" && hasValue) {
+            if (auto backend = WRITE_BACKEND.value(argv[++i]); backend.has_value()) {
+                config.backend = *backend;
+            } else {
+                std::fprintf(stderr, "Unknown backend: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (argument == "--sync" && hasValue) {
+            if (auto syncPolicy = SYNC_POLICY.value(argv[++i]); syncPolicy.has_value()) {
+                config.syncPolicy = *syncPolicy;
+            } else {
+                std::fprintf(stderr, "Unknown sync policy: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (argument == "--mode" && hasValue) {
+            if (auto mode = OVERWRITE_MODE.value(argv[++i]); mode.has_value()) {
+                config.modes.push_back(*mode);
+            } else {
+                std::fprintf(stderr, "Unknown overwrite mode: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (argument == "--tune") {
+            config.tune = true;
+        } else if (argument == "--threads" && hasValue) {
+            config.threads = std::max(std::atoi(argv[++i]), 1);
+        } else if (argument == "--repeat" && hasValue) {
+            config.repeat = std::max(std::atoi(argv[++i]), 1);
+        } else {
+            usage(argv[0]);
+            return argument == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (config.directories.empty()) {
+        for (const char* directory : {"/dev/shm", "/var/tmp"}) {
+            if (std::filesystem::is_directory(directory)) {
+                config.directories.emplace_back(directory);
+            }
+        }
+    }
+
+    run(config);
+
+    return EXIT_SUCCESS;
+}
@@ -22,16 +22,28 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <jni.h>
+#include <jni/UniqueJniEnv.hpp>
 #include <util/nullability/NonNull.hpp>
 #include <util/nullability/Nullable.hpp>
 
 #include "Task.hpp"
 #include "Generator.hpp"
-#include "FuturePromise.hpp"
+#include "Lazy.hpp"
+#include "Oneshot.hpp"
+#include "ThreadPool.hpp"
+#include "WhenAll.hpp"
 
 namespace {
     jclass generatorClass = nullptr;
@@ -48,6 +60,9 @@ namespace {
     jmethodID intValueMethodId = nullptr;
     jmethodID callMethodId = nullptr;
     jmethodID runMethodId = nullptr;
+
+    std::once_flag threadPoolFlag;
+    std::unique_ptr<kl::coroutine::ThreadPool> threadPool;
 }
 
 using namespace kl::util::nullability;
@@ -55,12 +70,76 @@ using namespace kl::util::nullability;
 namespace kl::coroutine {
 
     template<typename T>
-    std::future<Task<T>> executeTask(std::function<T()> callback) {
-        Task<T> task(std::move(callback));
+    Oneshot<Task<T>> executeTask(std::function<T()> callback, ThreadPool* pool) {
+        Task<T> task(std::move(callback), pool);
         co_await task;
         co_return task;
     }
 
+    /* result of call done on worker, references are global to pass them back to caller thread */
+    struct JvmCall final {
+        jobject value = nullptr;
+        jthrowable error = nullptr;
+        bool attached = true;
+    };
+
+    /* pool is started on first use, its own worker calls inline to not wait for itself */
+    static ThreadPool* choosePool() {
+        std::call_once(threadPoolFlag, [] {
+            threadPool = std::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+        });
+
+        return threadPool->isWorker() ? nullptr : threadPool.get();
+    }
+
+    template<typename Call>
+    static JvmCall callJvm(Call&& call) {
+        jni::UniqueJniEnv uniqueEnv;
+        JNIEnv* env = uniqueEnv.get();
+
+        if (env == nullptr) {
+            return {nullptr, nullptr, false};
+        }
+
+        JvmCall result;
+        env->PushLocalFrame(1);
+
+        jobject value = call(env);
+
+        if (jthrowable error = env->ExceptionOccurred(); error != nullptr) {
+            env->ExceptionClear();
+            result.error = static_cast<jthrowable>(env->NewGlobalRef(error));
+        } else if (value != nullptr) {
+            result.value = env->NewGlobalRef(value);
+        }
+
+        env->PopLocalFrame(nullptr);
+
+        return result;
+    }
+
+    /* rethrow error of call on caller thread, only the first error is thrown */
+    static jobject finishCall(const NonNull<JNIEnv*>& env, const JvmCall& call) {
+        jobject value = nullptr;
+
+        if (call.error != nullptr) {
+            if (!env->ExceptionCheck()) {
+                env->Throw(call.error);
+            }
+
+            env->DeleteGlobalRef(call.error);
+        } else if (!call.attached) {
+            if (!env->ExceptionCheck()) {
+                env->ThrowNew(coroutineExceptionClass, "Coroutine worker isn't attached to JVM");
+            }
+        } else if (call.value != nullptr) {
+            value = env->NewLocalRef(call.value);
+            env->DeleteGlobalRef(call.value);
+        }
+
+        return value;
+    }
+
     /*FIXME: using concept std::integral*/
     template<typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
     Generator<T> executeGenerator(T init_value, int begin, int end) {
@@ -73,9 +152,23 @@ namespace kl::coroutine {
         auto env = makeNonNull(rawEnv);
         auto beginTime = std::chrono::steady_clock::now();
 
-        std::future<Task<void>> future = executeTask<void>(
-                [&]() { env->CallVoidMethod(jvmRunnable, runMethodId); });
-        Task<void> task = future.get();
+        jobject runnable = env->NewGlobalRef(jvmRunnable);
+        JvmCall call;
+
+        Oneshot<Task<void>> oneshot = executeTask<void>([&]() {
+            call = callJvm([runnable](JNIEnv* workerEnv) {
+                workerEnv->CallVoidMethod(runnable, runMethodId);
+                return jobject{nullptr};
+            });
+        }, choosePool());
+        Task<void> task = oneshot.get();
+
+        env->DeleteGlobalRef(runnable);
+        finishCall(env, call);
+
+        if (env->ExceptionCheck()) {
+            return nullptr;
+        }
 
         auto endTime = std::chrono::steady_clock::now();
 
@@ -88,17 +181,82 @@ namespace kl::coroutine {
         auto env = makeNonNull(rawEnv);
         auto beginTime = std::chrono::steady_clock::now();
 
-        std::future<Task<Nullable<jobject>>> future = executeTask<Nullable<jobject>>(
-                [&]() { return env->CallObjectMethod(jvmCallable, callMethodId); });
-        Task<Nullable<jobject>> task = future.get();
+        jobject callable = env->NewGlobalRef(jvmCallable);
+        JvmCall call;
+
+        Oneshot<Task<Nullable<jobject>>> oneshot = executeTask<Nullable<jobject>>([&]() {
+            call = callJvm([callable](JNIEnv* workerEnv) {
+                return workerEnv->CallObjectMethod(callable, callMethodId);
+            });
+            return Nullable<jobject>(call.value);
+        }, choosePool());
+        Task<Nullable<jobject>> task = oneshot.get();
+
+        env->DeleteGlobalRef(callable);
+        jobject value = finishCall(env, call);
+
+        if (env->ExceptionCheck()) {
+            return nullptr;
+        }
 
         auto endTime = std::chrono::steady_clock::now();
 
         return env->NewObject(taskClass, taskConstructorId,
-                task.value.get(), task.finished ? JNI_TRUE : JNI_FALSE,
+                value, task.finished ? JNI_TRUE : JNI_FALSE,
                 std::chrono::duration_cast<std::chrono::milliseconds>(endTime - beginTime).count());
     }
 
+    static Lazy<void> callRunnable(jobject runnable, JvmCall& call) {
+        call = callJvm([runnable](JNIEnv* workerEnv) {
+            workerEnv->CallVoidMethod(runnable, runMethodId);
+            return jobject{nullptr};
+        });
+        co_return;
+    }
+
+    static Oneshot<void> executeAll(std::vector<Lazy<void>> lazies, ThreadPool* pool) {
+        co_await whenAll(pool, std::move(lazies));
+    }
+
+    /* runnables are run in parallel on workers of pool, caller is woken once after all of them */
+    jobject nativeAwaitAll(JNIEnv* rawEnv, jclass clazz, jobjectArray jvmRunnables) {
+        auto env = makeNonNull(rawEnv);
+        auto beginTime = std::chrono::steady_clock::now();
+
+        const jsize countRunnables = env->GetArrayLength(jvmRunnables);
+        std::vector<jobject> runnables(static_cast<std::size_t>(countRunnables));
+        std::vector<JvmCall> calls(runnables.size());
+        std::vector<Lazy<void>> lazies;
+        lazies.reserve(runnables.size());
+
+        for (jsize i = 0; i < countRunnables; ++i) {
+            jobject jvmRunnable = env->GetObjectArrayElement(jvmRunnables, i);
+            runnables[i] = env->NewGlobalRef(jvmRunnable);
+            env->DeleteLocalRef(jvmRunnable);
+        }
+
+        for (std::size_t i = 0; i < runnables.size(); ++i) {
+            lazies.push_back(callRunnable(runnables[i], calls[i]));
+        }
+
+        executeAll(std::move(lazies), choosePool()).get();
+
+        for (std::size_t i = 0; i < runnables.size(); ++i) {
+            env->DeleteGlobalRef(runnables[i]);
+            finishCall(env, calls[i]);
+        }
+
+        if (env->ExceptionCheck()) {
+            return nullptr;
+        }
+
+        auto endTime = std::chrono::steady_clock::now();
+
+        return env->NewObject(taskClass, taskConstructorId,
+              nullptr, JNI_TRUE,
+              std::chrono::duration_cast<std::chrono::milliseconds>(endTime - beginTime).count());
+    }
+
     jobject nativeYieldInRange(JNIEnv* rawEnv, jclass clazz, jobject jvmInitValue, jint jvmBegin, jint jvmEnd) {
         auto env = makeNonNull(rawEnv);
         auto beginTime = std::chrono::steady_clock::now();
@@ -133,11 +291,143 @@ namespace kl::coroutine {
         return nativeYieldInRange(rawEnv, clazz, jvmInitValue, 0, jvmCount);
     }
 
-    constexpr std::array<JNINativeMethod, 4> JNI_METHODS = {{
+    /* values are copied to jvm array by chunks, so there is one JNI call per chunk instead of per value */
+    static constexpr std::size_t TRANSFER_CHUNK_SIZE = 4096;
+
+    template<typename T, typename Store>
+    static bool transferGenerator(Generator<T>& generator, Store&& store) {
+        std::array<T, TRANSFER_CHUNK_SIZE> chunk;
+        std::size_t size = 0;
+        jsize offset = 0;
+
+        for (T value : generator) {
+            chunk[size++] = value;
+
+            if (size == chunk.size()) {
+                store(offset, static_cast<jsize>(size), chunk.data());
+                offset += static_cast<jsize>(size);
+                size = 0;
+            }
+        }
+
+        if (size > 0) {
+            store(offset, static_cast<jsize>(size), chunk.data());
+        }
+
+        return !generator.hasError();
+    }
+
+    static bool checkRange(const NonNull<JNIEnv*>& env, jint jvmBegin, jint jvmEnd) {
+        const jlong size = static_cast<jlong>(jvmEnd) - jvmBegin;
+
+        if (size < 0 || size > std::numeric_limits<jint>::max()) {
+            env->ThrowNew(coroutineExceptionClass, "Generator range is wrong");
+            return false;
+        }
+
+        return true;
+    }
+
+    jintArray nativeYieldInts(JNIEnv* rawEnv, jclass clazz, jint jvmInitValue, jint jvmBegin, jint jvmEnd) {
+        auto env = makeNonNull(rawEnv);
+
+        if (!checkRange(env, jvmBegin, jvmEnd)) {
+            return nullptr;
+        }
+
+        jintArray jvmNumbers = env->NewIntArray(jvmEnd - jvmBegin);
+
+        if (jvmNumbers == nullptr) {
+            return nullptr;
+        }
+
+        auto generator = executeGenerator(jvmInitValue, jvmBegin, jvmEnd);
+        bool success = transferGenerator(generator, [&](jsize offset, jsize size, const jint* values) {
+            env->SetIntArrayRegion(jvmNumbers, offset, size, values);
+        });
+
+        if (!success) {
+            env->ThrowNew(coroutineExceptionClass, "Generator take native coroutine error");
+            return nullptr;
+        }
+
+        return jvmNumbers;
+    }
+
+    jlongArray nativeYieldLongs(JNIEnv* rawEnv, jclass clazz, jlong jvmInitValue, jint jvmBegin, jint jvmEnd) {
+        auto env = makeNonNull(rawEnv);
+
+        if (!checkRange(env, jvmBegin, jvmEnd)) {
+            return nullptr;
+        }
+
+        jlongArray jvmNumbers = env->NewLongArray(jvmEnd - jvmBegin);
+
+        if (jvmNumbers == nullptr) {
+            return nullptr;
+        }
+
+        auto generator = executeGenerator(jvmInitValue, jvmBegin, jvmEnd);
+        bool success = transferGenerator(generator, [&](jsize offset, jsize size, const jlong* values) {
+            env->SetLongArrayRegion(jvmNumbers, offset, size, values);
+        });
+
+        if (!success) {
+            env->ThrowNew(coroutineExceptionClass, "Generator take native coroutine error");
+            return nullptr;
+        }
+
+        return jvmNumbers;
+    }
+
+    /* ints in native byte order are written to direct buffer without copy, count of them is returned */
+    /* position and remaining are in bytes, buffer could be unaligned, so ints are copied */
+    jint nativeYieldInto(JNIEnv* rawEnv, jclass clazz, jint jvmInitValue, jint jvmBegin, jint jvmEnd,
+                         jobject jvmBuffer, jint jvmPosition, jint jvmRemaining) {
+        auto env = makeNonNull(rawEnv);
+
+        if (!checkRange(env, jvmBegin, jvmEnd)) {
+            return -1;
+        }
+
+        auto* address = static_cast<std::uint8_t*>(env->GetDirectBufferAddress(jvmBuffer));
+        const jlong capacity = env->GetDirectBufferCapacity(jvmBuffer);
+
+        if (address == nullptr || capacity < 0) {
+            env->ThrowNew(coroutineExceptionClass, "Generator could fill only direct buffer");
+            return -1;
+        }
+
+        if (jvmPosition < 0 || jvmRemaining < 0 || static_cast<jlong>(jvmPosition) + jvmRemaining > capacity) {
+            env->ThrowNew(coroutineExceptionClass, "Buffer position is out of its capacity");
+            return -1;
+        }
+
+        std::uint8_t* target = address + jvmPosition;
+        const jint count = static_cast<jint>(std::min<jlong>(static_cast<jlong>(jvmEnd) - jvmBegin,
+                                                             jvmRemaining / static_cast<jint>(sizeof(jint))));
+        auto generator = executeGenerator(jvmInitValue, jvmBegin, jvmBegin + count);
+        bool success = transferGenerator(generator, [&](jsize offset, jsize size, const jint* values) {
+            std::memcpy(target + offset * sizeof(jint), values, size * sizeof(jint));
+        });
+
+        if (!success) {
+            env->ThrowNew(coroutineExceptionClass, "Generator take native coroutine error");
+            return -1;
+        }
+
+        return count;
+    }
+
+    constexpr std::array<JNINativeMethod, 8> JNI_METHODS = {{
         {"await", "(Ljava/lang/Runnable;)Lorg/kl/firearrow/coroutine/Task;", (void*)nativeAwaitRunnable},
         {"await", "(Ljava/util/concurrent/Callable;)Lorg/kl/firearrow/coroutine/Task;", (void*)nativeAwaitCallable},
+        {"awaitAll", "([Ljava/lang/Runnable;)Lorg/kl/firearrow/coroutine/Task;", (void*)nativeAwaitAll},
         {"yield", "(Ljava/lang/Number;I)Lorg/kl/firearrow/coroutine/Generator;", (void*)nativeYield},
         {"yield", "(Ljava/lang/Number;II)Lorg/kl/firearrow/coroutine/Generator;", (void*)nativeYieldInRange},
+        {"yieldInts", "(III)[I", (void*)nativeYieldInts},
+        {"yieldLongs", "(JII)[J", (void*)nativeYieldLongs},
+        {"yieldInto", "(IIILjava/nio/ByteBuffer;II)I", (void*)nativeYieldInto},
     }};
 }
 
@@ -179,6 +469,8 @@ jint registerCoroutineManager(JNIEnv* rawEnv) {
 void unregisterCoroutineManager(JNIEnv* rawEnv) {
     auto env = makeNonNull(rawEnv);
 
+    threadPool.reset();
+
     env->DeleteGlobalRef(coroutineExceptionClass);
     env->DeleteGlobalRef(callableClass);
     env->DeleteGlobalRef(runnableClass);
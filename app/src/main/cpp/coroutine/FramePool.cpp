@@ -0,0 +1,106 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "FramePool.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <new>
+
+namespace kl::coroutine {
+    static constexpr std::size_t COUNT_CLASSES = std::countr_zero(MAX_FRAME_SIZE / MIN_FRAME_SIZE) + 1;
+
+    static std::atomic<bool> poolEnabled = true;
+
+    /* freed frame keeps pointer to the next one */
+    struct FreeFrame final {
+        FreeFrame* next;
+    };
+
+    struct FrameCache final {
+        std::array<FreeFrame*, COUNT_CLASSES> heads = {};
+        std::array<std::size_t, COUNT_CLASSES> counts = {};
+
+        /* frames freed later by thread destructors go to operator delete */
+        ~FrameCache() {
+            for (std::size_t i = 0; i < COUNT_CLASSES; ++i) {
+                while (heads[i] != nullptr) {
+                    FreeFrame* frame = heads[i];
+                    heads[i] = frame->next;
+                    ::operator delete(frame);
+                }
+
+                counts[i] = MAX_CACHED_FRAMES;
+            }
+        }
+    };
+
+    static thread_local FrameCache frameCache;
+
+    static constexpr std::size_t sizeClass(std::size_t size) {
+        return size <= MIN_FRAME_SIZE ? 0 : std::bit_width((size - 1) / MIN_FRAME_SIZE);
+    }
+
+    static_assert(sizeClass(MIN_FRAME_SIZE) == 0 && sizeClass(MIN_FRAME_SIZE + 1) == 1);
+    static_assert(sizeClass(MAX_FRAME_SIZE) == COUNT_CLASSES - 1);
+
+    void* allocateFrame(std::size_t size) {
+        if (size > MAX_FRAME_SIZE) {
+            return ::operator new(size);
+        }
+
+        const std::size_t index = sizeClass(size);
+        FrameCache& cache = frameCache;
+
+        if (FreeFrame* frame = cache.heads[index]; frame != nullptr && poolEnabled.load(std::memory_order_relaxed)) {
+            cache.heads[index] = frame->next;
+            --cache.counts[index];
+            return frame;
+        }
+
+        return ::operator new(MIN_FRAME_SIZE << index);
+    }
+
+    void deallocateFrame(void* frame, std::size_t size) noexcept {
+        if (size > MAX_FRAME_SIZE) {
+            ::operator delete(frame);
+            return;
+        }
+
+        const std::size_t index = sizeClass(size);
+        FrameCache& cache = frameCache;
+
+        if (cache.counts[index] == MAX_CACHED_FRAMES || !poolEnabled.load(std::memory_order_relaxed)) {
+            ::operator delete(frame);
+            return;
+        }
+
+        cache.heads[index] = new (frame) FreeFrame{cache.heads[index]};
+        ++cache.counts[index];
+    }
+
+    void setFramePoolEnabled(bool enabled) noexcept {
+        poolEnabled.store(enabled, std::memory_order_relaxed);
+    }
+}
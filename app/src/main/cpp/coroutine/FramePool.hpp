@@ -0,0 +1,55 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace kl::coroutine {
+    /* frames up to the largest class are rounded up to power of two, bigger ones go to operator new */
+    inline constexpr std::size_t MIN_FRAME_SIZE = 64;
+    inline constexpr std::size_t MAX_FRAME_SIZE = 4096;
+    /* frames kept per class and thread, e.g. frames allocated on one thread and freed on another */
+    inline constexpr std::size_t MAX_CACHED_FRAMES = 64;
+
+    /*
+     * Frame is taken from free list of its size class on current thread. Frame
+     * freed on other thread is put to list of that thread, when it isn't full.
+     */
+    void* allocateFrame(std::size_t size);
+    void deallocateFrame(void* frame, std::size_t size) noexcept;
+
+    /* disabled pool keeps rounding of sizes, so frame could be freed after switch, e.g. for benchmark */
+    void setFramePoolEnabled(bool enabled) noexcept;
+
+    /* base of promise types, frames of their coroutines are taken from pool */
+    struct PooledFrame {
+        static void* operator new(std::size_t size) {
+            return allocateFrame(size);
+        }
+
+        static void operator delete(void* frame, std::size_t size) noexcept {
+            deallocateFrame(frame, size);
+        }
+    };
+}
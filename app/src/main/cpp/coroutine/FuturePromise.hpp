@@ -40,7 +40,7 @@ struct std::experimental::coroutine_traits<std::future<R>, Args...> {
         }
 
         void unhandled_exception() /*customisable*/ {
-            std::current_exception();
+            offer.set_exception(std::current_exception());
         }
 
         template <typename U>
@@ -66,7 +66,7 @@ struct std::experimental::coroutine_traits<std::future<void>, Args...> {
         }
 
         void unhandled_exception() /*customisable*/ {
-            std::current_exception();
+            offer.set_exception(std::current_exception());
         }
 
         void return_void() /*customisable*/ {
@@ -28,6 +28,8 @@
 
 #include <util/nullability/Nullable.hpp>
 
+#include "FramePool.hpp"
+
 namespace kl::coroutine {
     using namespace kl::util::nullability;
 
@@ -35,7 +37,7 @@ namespace kl::coroutine {
     class Generator;
 
     template<typename T>
-    struct GeneratorPromise final {
+    struct GeneratorPromise final : public PooledFrame {
         using Reference = std::conditional_t<std::is_reference_v<T>, T, T&>;
         using Pointer = Nullable<std::remove_reference_t<T>*>;
 
@@ -0,0 +1,138 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <exception>
+#include <experimental/coroutine>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "FramePool.hpp"
+#include "Lazy.hpp"
+#include "ThreadPool.hpp"
+
+namespace kl::coroutine {
+
+    /* value of lazy kept by combinators: void is std::monostate, reference is std::reference_wrapper */
+    template<typename T>
+    using LazyResult = std::conditional_t<std::is_void_v<T>, std::monostate,
+                       std::conditional_t<std::is_reference_v<T>,
+                                          std::reference_wrapper<std::remove_reference_t<T>>, T>>;
+
+    template<typename T>
+    LazyResult<T> takeResult(const Lazy<T>& lazy) {
+        if constexpr (std::is_void_v<T>) {
+            lazy.result();
+            return {};
+        } else {
+            return lazy.result();
+        }
+    }
+
+    /* shared state of lazy group, it's told about each finished child */
+    class GroupCounter {
+    public:
+        /* coroutine resumed after finished child, e.g. awaiting parent */
+        virtual std::experimental::coroutine_handle<> finish(std::size_t index) noexcept = 0;
+
+    protected:
+        ~GroupCounter() = default;
+    };
+
+    /*
+     * Coroutine, which runs one child of group: it moves to worker of pool when
+     * pool is set, waits for child lazy and reports to the counter in the end.
+     */
+    class GroupTask final {
+    public:
+        class promise_type final : public PooledFrame {
+        public:
+            GroupTask get_return_object() noexcept /*customisable*/ {
+                return GroupTask(std::experimental::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::experimental::suspend_always initial_suspend() const noexcept /*customisable*/ { return {}; }
+            auto final_suspend() const noexcept /*customisable*/ { return Awaitable(); }
+
+            /* child exception stays in its lazy, only posting to pool could throw here */
+            void unhandled_exception() noexcept /*customisable*/ { std::terminate(); }
+            void return_void() noexcept /*customisable*/ {}
+
+        private:
+            friend class GroupTask;
+
+            struct Awaitable final {
+                bool await_ready() const noexcept /*customisable*/ { return false; }
+                void await_resume() const noexcept /*customisable*/ {}
+
+                std::experimental::coroutine_handle<>
+                await_suspend(std::experimental::coroutine_handle<promise_type> handle) const noexcept /*customisable*/ {
+                    promise_type& promise = handle.promise();
+                    return promise.counter->finish(promise.index);
+                }
+            };
+
+            GroupCounter* counter = nullptr;
+            std::size_t index = 0;
+        };
+
+        GroupTask() noexcept : handle(nullptr) {}
+        explicit GroupTask(std::experimental::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+        ~GroupTask() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        GroupTask(const GroupTask&) = delete;
+        GroupTask& operator=(const GroupTask&) = delete;
+
+        GroupTask(GroupTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        GroupTask& operator=(GroupTask&& other) noexcept {
+            std::swap(handle, other.handle);
+            return *this;
+        }
+
+        void start(GroupCounter& counter, std::size_t index) {
+            handle.promise().counter = &counter;
+            handle.promise().index = index;
+            handle.resume();
+        }
+
+    private:
+        std::experimental::coroutine_handle<promise_type> handle;
+    };
+
+    template<typename T>
+    GroupTask runChild(const Lazy<T>& lazy, ThreadPool* pool) {
+        if (pool != nullptr) {
+            co_await pool->schedule();
+        }
+
+        co_await lazy.whenReady();
+    }
+}
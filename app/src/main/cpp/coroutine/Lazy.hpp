@@ -30,6 +30,8 @@
 #include <util/nullability/Nullable.hpp>
 #include <util/error/Result.hpp>
 
+#include "FramePool.hpp"
+
 namespace kl::coroutine {
     using namespace kl::util::property;
     using namespace kl::util::nullability;
@@ -38,7 +40,7 @@ namespace kl::coroutine {
     template<typename T>
     class Lazy;
 
-    class LazyPromiseBase {
+    class LazyPromiseBase : public PooledFrame {
     public:
         explicit LazyPromiseBase() noexcept : continuation(continuation_) {}
 
@@ -101,7 +103,7 @@ namespace kl::coroutine {
             error = std::current_exception();
         }
 
-        void return_value() noexcept /*customisable*/ {}
+        void return_void() noexcept /*customisable*/ {}
 
         void result() const {
             if (error) {
@@ -210,6 +212,37 @@ namespace kl::coroutine {
             return Awaitable(continuation);
         }
 
+        /* co_await lazy.whenReady() runs lazy up to the end, its result stays inside */
+        auto whenReady() const noexcept {
+            struct Awaitable final {
+
+                explicit Awaitable(std::experimental::coroutine_handle<promise_type> continuation)
+                    : continuation(continuation) {
+                }
+
+                bool await_ready() const noexcept /*customisable*/ {
+                    return !continuation || continuation.done();
+                }
+
+                void await_resume() const noexcept /*customisable*/ {}
+
+                std::experimental::coroutine_handle<>
+                await_suspend(std::experimental::coroutine_handle<> handle) noexcept /*customisable*/ {
+                    continuation.promise().continuation = handle;
+                    return continuation;
+                }
+
+                std::experimental::coroutine_handle<promise_type> continuation;
+            };
+
+            return Awaitable(continuation);
+        }
+
+        /* result of finished lazy, exception of its coroutine is rethrown */
+        decltype(auto) result() const {
+            return continuation.promise().result();
+        }
+
     private:
         std::experimental::coroutine_handle<promise_type> continuation;
     };
@@ -219,7 +252,7 @@ namespace kl::coroutine {
         return Lazy<T>(std::experimental::coroutine_handle<LazyPromise>::from_promise(*this));
     }
 
-    Lazy<void> LazyPromise<void>::get_return_object() noexcept {
+    inline Lazy<void> LazyPromise<void>::get_return_object() noexcept {
         return Lazy<void>(std::experimental::coroutine_handle<LazyPromise>::from_promise(*this));
     }
 
@@ -0,0 +1,206 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <experimental/coroutine>
+#include <optional>
+#include <utility>
+
+#include "FramePool.hpp"
+
+namespace kl::coroutine {
+
+    template<typename T>
+    class Oneshot;
+
+    /*
+     * Result of eager coroutine, which is kept in its own frame. Coroutine and
+     * Oneshot share atomic state, the side coming last destroys the frame, so
+     * there is neither shared allocation nor mutex as in std::future.
+     */
+    class OneshotPromiseBase : public PooledFrame {
+    public:
+        enum State : std::uint32_t {
+            PENDING_STATE = 0,
+            WAITING_STATE = 1,
+            READY_STATE = 2,
+            DETACHED_STATE = 3
+        };
+
+        OneshotPromiseBase() noexcept : state(PENDING_STATE) {}
+
+        std::experimental::suspend_never initial_suspend() const noexcept /*customisable*/ { return {}; }
+        auto final_suspend() const noexcept /*customisable*/ { return Awaitable(); }
+
+        void unhandled_exception() noexcept /*customisable*/ {
+            error = std::current_exception();
+        }
+
+        /* block until coroutine is finished, futex is used only when result isn't ready yet */
+        void wait() noexcept {
+            std::uint32_t current = state.load(std::memory_order_acquire);
+
+            while (current != READY_STATE) {
+                if (current == PENDING_STATE &&
+                    !state.compare_exchange_weak(current, WAITING_STATE, std::memory_order_acquire)) {
+                    continue;
+                }
+
+                ::syscall(__NR_futex, address(), FUTEX_WAIT_PRIVATE, WAITING_STATE, nullptr, nullptr, 0);
+                current = state.load(std::memory_order_acquire);
+            }
+        }
+
+        bool isReady() const noexcept {
+            return state.load(std::memory_order_acquire) == READY_STATE;
+        }
+
+        /* true when coroutine is already finished, otherwise it destroys own frame at the end */
+        bool detach() noexcept {
+            return state.exchange(DETACHED_STATE, std::memory_order_acq_rel) == READY_STATE;
+        }
+
+    protected:
+        void rethrow() const {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        struct Awaitable final {
+            bool await_ready() const noexcept /*customisable*/ { return false; }
+            void await_resume() const noexcept /*customisable*/ {}
+
+            /*
+             * Waiter could destroy frame right after state is changed, so only
+             * locals are used then. Private futex wake doesn't touch memory.
+             */
+            template<typename Promise>
+            bool await_suspend(std::experimental::coroutine_handle<Promise> handle) const noexcept /*customisable*/ {
+                OneshotPromiseBase& promise = handle.promise();
+                std::uint32_t* address = promise.address();
+                const std::uint32_t previous = promise.state.exchange(READY_STATE, std::memory_order_acq_rel);
+
+                if (previous == WAITING_STATE) {
+                    ::syscall(__NR_futex, address, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+                }
+
+                return previous != DETACHED_STATE;
+            }
+        };
+
+        std::uint32_t* address() noexcept {
+            static_assert(sizeof(state) == sizeof(std::uint32_t) && std::atomic<std::uint32_t>::is_always_lock_free);
+            return reinterpret_cast<std::uint32_t*>(&state);
+        }
+
+        std::atomic<std::uint32_t> state;
+        std::exception_ptr error;
+    };
+
+    template<typename T>
+    class OneshotPromise final : public OneshotPromiseBase {
+    public:
+        Oneshot<T> get_return_object() noexcept /*customisable*/;
+
+        template<typename V>
+        void return_value(V&& other) /*customisable*/ {
+            value.emplace(std::forward<V>(other));
+        }
+
+        T result() {
+            rethrow();
+            return std::move(*value);
+        }
+
+    private:
+        std::optional<T> value;
+    };
+
+    template<>
+    class OneshotPromise<void> final : public OneshotPromiseBase {
+    public:
+        Oneshot<void> get_return_object() noexcept /*customisable*/;
+
+        void return_void() noexcept /*customisable*/ {}
+
+        void result() {
+            rethrow();
+        }
+    };
+
+    /* handle of eager coroutine with one result, get() blocks as std::future::get() */
+    template<typename T = void>
+    class [[nodiscard]] Oneshot final {
+    public:
+        /*customisable*/
+        using promise_type = OneshotPromise<T>;
+
+        explicit Oneshot(std::experimental::coroutine_handle<promise_type> handle) noexcept
+            : handle(handle) {
+        }
+
+        ~Oneshot() {
+            if (handle && handle.promise().detach()) {
+                handle.destroy();
+            }
+        }
+
+        Oneshot(const Oneshot&) = delete;
+        Oneshot& operator=(const Oneshot&) = delete;
+
+        Oneshot(Oneshot&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Oneshot& operator=(Oneshot&& other) = delete;
+
+        [[nodiscard]] bool isReady() const noexcept {
+            return handle.promise().isReady();
+        }
+
+        /* result or rethrown exception of coroutine, could be taken only once */
+        T get() {
+            handle.promise().wait();
+            return handle.promise().result();
+        }
+
+    private:
+        std::experimental::coroutine_handle<promise_type> handle;
+    };
+
+    template<typename T>
+    Oneshot<T> OneshotPromise<T>::get_return_object() noexcept {
+        return Oneshot<T>(std::experimental::coroutine_handle<OneshotPromise>::from_promise(*this));
+    }
+
+    inline Oneshot<void> OneshotPromise<void>::get_return_object() noexcept {
+        return Oneshot<void>(std::experimental::coroutine_handle<OneshotPromise>::from_promise(*this));
+    }
+}
@@ -25,28 +25,66 @@
 #pragma once
 
 #include <experimental/coroutine>
+#include <functional>
 
 #include <util/property/Getter.hpp>
 
+#include "ThreadPool.hpp"
+
 namespace kl::coroutine {
     using namespace kl::util::property;
 
+    /*
+     * Callback runs inline on awaiting thread, or on worker of pool when it's
+     * set. In the last case awaiting coroutine continues on that worker too.
+     */
     template<typename T>
     class Task final {
+    private:
+        /* declared before getters, which bind to them */
+        std::function<T()> callback;
+        ThreadPool* pool;
+        T value_;
+        bool finished_;
+
     public:
-        explicit Task(std::function<T()> callback)
-            : value(value_)
-            , finished(finished_)
-            , callback(std::move(callback))
-            , value_(nullptr)
-            , finished_(false) {
+        explicit Task(std::function<T()> callback, ThreadPool* pool = nullptr)
+            : callback(std::move(callback))
+            , pool(pool)
+            , value_()
+            , finished_(false)
+            , value(value_)
+            , finished(finished_) {
+        }
+
+        /* getters are bound to own fields, task is copied out of finished coroutine frame */
+        Task(const Task& other)
+            : callback(other.callback)
+            , pool(other.pool)
+            , value_(other.value_)
+            , finished_(other.finished_)
+            , value(value_)
+            , finished(finished_) {
         }
 
         ~Task() = default;
 
+        Task& operator=(const Task&) = delete;
+
         bool await_ready() const /*customisable*/ { return false; }
-        void await_resume() /*customisable*/ {}
+        void await_resume() /*customisable*/ {
+            if (pool != nullptr) {
+                value_ = callback();
+                finished_ = true;
+            }
+        }
+
         void await_suspend(std::experimental::coroutine_handle<> handler) /*customisable*/ {
+            if (pool != nullptr) {
+                pool->post(handler);
+                return;
+            }
+
             value_ = callback();
 
             if (!handler.done()) {
@@ -57,27 +95,48 @@ namespace kl::coroutine {
 
         Getter<T&> value;
         Getter<bool&> finished;
-
-    private:
-        std::function<T()> callback;
-        T value_;
-        bool finished_;
     };
 
     template<>
     class Task<void> final {
+    private:
+        std::function<void()> callback;
+        ThreadPool* pool;
+        bool finished_;
+
     public:
-        explicit Task(std::function<void()> callback)
-            : finished(finished_)
-            , callback(std::move(callback))
-            , finished_(false) {
+        explicit Task(std::function<void()> callback, ThreadPool* pool = nullptr)
+            : callback(std::move(callback))
+            , pool(pool)
+            , finished_(false)
+            , finished(finished_) {
+        }
+
+        Task(const Task& other)
+            : callback(other.callback)
+            , pool(other.pool)
+            , finished_(other.finished_)
+            , finished(finished_) {
         }
 
         ~Task() = default;
 
+        Task& operator=(const Task&) = delete;
+
         bool await_ready() const /*customisable*/ { return false; }
-        void await_resume() /*customisable*/ {}
+        void await_resume() /*customisable*/ {
+            if (pool != nullptr) {
+                callback();
+                finished_ = true;
+            }
+        }
+
         void await_suspend(std::experimental::coroutine_handle<> handler) /*customisable*/ {
+            if (pool != nullptr) {
+                pool->post(handler);
+                return;
+            }
+
             callback();
 
             if (!handler.done()) {
@@ -87,9 +146,5 @@ namespace kl::coroutine {
         }
 
         Getter<bool&> finished;
-
-    private:
-        std::function<void()> callback;
-        bool finished_;
     };
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "ThreadPool.hpp"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#include <jni/UniqueJniEnv.hpp>
+#include <logging/Logging.hpp>
+
+namespace kl::coroutine {
+    static constexpr const char* TAG = "ThreadPool-JNI";
+
+    /* pool and index of worker running on current thread */
+    static thread_local const ThreadPool* currentPool = nullptr;
+    static thread_local std::size_t currentWorker = 0;
+
+    ThreadPool::ThreadPool(std::size_t countThreads)
+        : nextWorker(0)
+        , countPending(0)
+        , stopped(false) {
+        countThreads = std::max<std::size_t>(countThreads, 1);
+        workers.reserve(countThreads);
+
+        for (std::size_t i = 0; i < countThreads; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+
+        for (std::size_t i = 0; i < countThreads; ++i) {
+            workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+        }
+    }
+
+    /* coroutines posted before stop are still resumed */
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+
+        condition.notify_all();
+
+        for (auto& worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    void ThreadPool::post(std::experimental::coroutine_handle<> handle) {
+        const std::size_t index = isWorker()
+                ? currentWorker
+                : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+        /* counted before publishing, so worker which takes it never decrements below zero */
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            countPending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->handles.push_back(handle);
+        }
+
+        condition.notify_one();
+    }
+
+    bool ThreadPool::isWorker() const noexcept {
+        return currentPool == this;
+    }
+
+    std::experimental::coroutine_handle<> ThreadPool::take(std::size_t index) {
+        {
+            Worker& own = *workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+
+            if (!own.handles.empty()) {
+                auto handle = own.handles.back();
+                own.handles.pop_back();
+                return handle;
+            }
+        }
+
+        for (std::size_t i = 1; i < workers.size(); ++i) {
+            Worker& victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            if (!victim.handles.empty()) {
+                auto handle = victim.handles.front();
+                victim.handles.pop_front();
+                return handle;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void ThreadPool::run(std::size_t index) {
+        char name[16] = {};
+        std::snprintf(name, sizeof(name), "firearrow-%zu", index);
+        ::pthread_setname_np(::pthread_self(), name);
+
+        jni::UniqueJniEnv env(name);
+        currentPool = this;
+        currentWorker = index;
+
+        if (env.get() == nullptr) {
+            log::debug(TAG, "Worker %s runs without JVM", name);
+        }
+
+        while (true) {
+            if (auto handle = take(index)) {
+                countPending.fetch_sub(1, std::memory_order_relaxed);
+                handle.resume();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return countPending.load(std::memory_order_relaxed) > 0 || stopped; });
+
+            if (stopped && countPending.load(std::memory_order_relaxed) == 0) {
+                break;
+            }
+        }
+
+        currentPool = nullptr;
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <experimental/coroutine>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kl::coroutine {
+
+    /*
+     * Work-stealing pool of coroutines. Each worker has own deque: the worker
+     * resumes the newest coroutine from its back, idle workers steal the oldest
+     * one from front of others. Workers are attached to JVM while pool is alive,
+     * so Java could be called from resumed coroutine without attach per call.
+     */
+    class ThreadPool final {
+    public:
+        explicit ThreadPool(std::size_t countThreads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /* coroutine posted by worker goes to its own deque, other ones are spread between workers */
+        void post(std::experimental::coroutine_handle<> handle);
+
+        /* co_await pool.schedule() continues the coroutine on one of workers */
+        auto schedule() noexcept {
+            struct Awaitable final {
+                bool await_ready() const noexcept /*customisable*/ { return false; }
+                void await_resume() const noexcept /*customisable*/ {}
+                void await_suspend(std::experimental::coroutine_handle<> handle) /*customisable*/ {
+                    pool.post(handle);
+                }
+
+                ThreadPool& pool;
+            };
+
+            return Awaitable{*this};
+        }
+
+        /* true on worker of this pool, blocking wait there could starve the pool */
+        bool isWorker() const noexcept;
+
+        std::size_t countThreads() const noexcept { return workers.size(); }
+
+    private:
+        struct Worker final {
+            std::mutex mutex;
+            std::deque<std::experimental::coroutine_handle<>> handles;
+            std::thread thread;
+        };
+
+        void run(std::size_t index);
+        std::experimental::coroutine_handle<> take(std::size_t index);
+
+    private:
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<std::size_t> nextWorker;
+        std::atomic<std::size_t> countPending;
+        bool stopped;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+}
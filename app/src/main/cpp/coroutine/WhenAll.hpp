@@ -0,0 +1,172 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <experimental/coroutine>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "GroupTask.hpp"
+#include "Lazy.hpp"
+#include "ThreadPool.hpp"
+
+namespace kl::coroutine {
+
+    /*
+     * Countdown of children and awaiting parent. Parent holds one count while
+     * it starts children, so it's resumed only once, either by the last child
+     * or without suspension when all children are finished inline.
+     */
+    class WhenAllCounter : public GroupCounter {
+    public:
+        std::experimental::coroutine_handle<> finish(std::size_t) noexcept override {
+            if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                return parent;
+            }
+
+            return std::experimental::noop_coroutine();
+        }
+
+    protected:
+        template<typename Start>
+        bool suspend(std::experimental::coroutine_handle<> handle, std::size_t countChildren, Start&& start) {
+            parent = handle;
+            count.store(countChildren + 1, std::memory_order_relaxed);
+            start();
+
+            /* parent could be resumed right after decrement, awaitable isn't touched then */
+            return count.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        ~WhenAllCounter() = default;
+
+    private:
+        std::atomic<std::size_t> count = 0;
+        std::experimental::coroutine_handle<> parent;
+    };
+
+    template<typename... Ts>
+    class WhenAllAwaitable final : public WhenAllCounter {
+    public:
+        WhenAllAwaitable(ThreadPool* pool, Lazy<Ts>&&... lazies)
+            : lazies(std::move(lazies)...)
+            , pool(pool) {
+        }
+
+        bool await_ready() const noexcept /*customisable*/ { return sizeof...(Ts) == 0; }
+
+        bool await_suspend(std::experimental::coroutine_handle<> handle) /*customisable*/ {
+            return suspend(handle, sizeof...(Ts), [this] { start(std::index_sequence_for<Ts...>()); });
+        }
+
+        /* the first failed child in order of arguments rethrows its exception */
+        std::tuple<LazyResult<Ts>...> await_resume() /*customisable*/ {
+            return std::apply([](const auto&... lazy) { return std::tuple<LazyResult<Ts>...>{takeResult(lazy)...}; },
+                              lazies);
+        }
+
+    private:
+        template<std::size_t... Is>
+        void start(std::index_sequence<Is...>) {
+            ((tasks[Is] = runChild(std::get<Is>(lazies), pool)), ...);
+            (tasks[Is].start(*this, Is), ...);
+        }
+
+        std::tuple<Lazy<Ts>...> lazies;
+        std::array<GroupTask, sizeof...(Ts)> tasks;
+        ThreadPool* pool;
+    };
+
+    template<typename T>
+    class WhenAllRangeAwaitable final : public WhenAllCounter {
+    public:
+        WhenAllRangeAwaitable(ThreadPool* pool, std::vector<Lazy<T>>&& lazies)
+            : lazies(std::move(lazies))
+            , pool(pool) {
+        }
+
+        bool await_ready() const noexcept /*customisable*/ { return lazies.empty(); }
+
+        bool await_suspend(std::experimental::coroutine_handle<> handle) /*customisable*/ {
+            tasks.reserve(lazies.size());
+
+            for (const auto& lazy : lazies) {
+                tasks.push_back(runChild(lazy, pool));
+            }
+
+            return suspend(handle, tasks.size(), [this] {
+                for (std::size_t i = 0; i < tasks.size(); ++i) {
+                    tasks[i].start(*this, i);
+                }
+            });
+        }
+
+        /* results in order of lazies, the first failed child rethrows its exception */
+        auto await_resume() /*customisable*/ {
+            if constexpr (std::is_void_v<T>) {
+                for (const auto& lazy : lazies) {
+                    lazy.result();
+                }
+            } else {
+                std::vector<LazyResult<T>> results;
+                results.reserve(lazies.size());
+
+                for (const auto& lazy : lazies) {
+                    results.push_back(takeResult(lazy));
+                }
+
+                return results;
+            }
+        }
+
+    private:
+        std::vector<Lazy<T>> lazies;
+        std::vector<GroupTask> tasks;
+        ThreadPool* pool;
+    };
+
+    /* co_await whenAll(...) runs lazies, on workers of pool when it's set, and resumes once all finished */
+    template<typename... Ts>
+    WhenAllAwaitable<Ts...> whenAll(ThreadPool* pool, Lazy<Ts>... lazies) {
+        return WhenAllAwaitable<Ts...>(pool, std::move(lazies)...);
+    }
+
+    template<typename... Ts>
+    WhenAllAwaitable<Ts...> whenAll(Lazy<Ts>... lazies) {
+        return WhenAllAwaitable<Ts...>(nullptr, std::move(lazies)...);
+    }
+
+    template<typename T>
+    WhenAllRangeAwaitable<T> whenAll(ThreadPool* pool, std::vector<Lazy<T>> lazies) {
+        return WhenAllRangeAwaitable<T>(pool, std::move(lazies));
+    }
+
+    template<typename T>
+    WhenAllRangeAwaitable<T> whenAll(std::vector<Lazy<T>> lazies) {
+        return WhenAllRangeAwaitable<T>(nullptr, std::move(lazies));
+    }
+}
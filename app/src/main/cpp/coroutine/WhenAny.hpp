@@ -0,0 +1,154 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <atomic>
+#include <experimental/coroutine>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "GroupTask.hpp"
+#include "Lazy.hpp"
+#include "ThreadPool.hpp"
+
+namespace kl::coroutine {
+
+    /*
+     * Lazies can't be cancelled, so the rest of children keep running after
+     * parent is resumed by the first one. Their state is moved to one group
+     * allocation, which is deleted by the last of children and parent.
+     */
+    template<typename T>
+    class WhenAnyAwaitable final {
+    public:
+        WhenAnyAwaitable(ThreadPool* pool, std::vector<Lazy<T>>&& lazies)
+            : group(new Group(pool, std::move(lazies))) {
+        }
+
+        ~WhenAnyAwaitable() {
+            group->release();
+        }
+
+        WhenAnyAwaitable(const WhenAnyAwaitable&) = delete;
+        WhenAnyAwaitable& operator=(const WhenAnyAwaitable&) = delete;
+
+        bool await_ready() const noexcept /*customisable*/ { return false; }
+
+        bool await_suspend(std::experimental::coroutine_handle<> handle) /*customisable*/ {
+            return group->suspend(handle);
+        }
+
+        /* index and result of the first finished lazy, its exception is rethrown */
+        std::pair<std::size_t, LazyResult<T>> await_resume() /*customisable*/ {
+            const std::size_t winner = group->winner;
+            return {winner, takeResult(group->lazies[winner])};
+        }
+
+    private:
+        class Group final : public GroupCounter {
+        public:
+            Group(ThreadPool* pool, std::vector<Lazy<T>>&& lazies)
+                : lazies(std::move(lazies))
+                , pool(pool)
+                , count(1)
+                , gate(2)
+                , finished(false)
+                , winner(0) {
+            }
+
+            /* parent isn't resumed before it's suspended, so it passes the gate as winner does */
+            bool suspend(std::experimental::coroutine_handle<> handle) {
+                parent = handle;
+                tasks.reserve(lazies.size());
+
+                for (const auto& lazy : lazies) {
+                    tasks.push_back(runChild(lazy, pool));
+                }
+
+                count.fetch_add(tasks.size(), std::memory_order_relaxed);
+
+                for (std::size_t i = 0; i < tasks.size(); ++i) {
+                    if (finished.load(std::memory_order_acquire)) {
+                        count.fetch_sub(tasks.size() - i, std::memory_order_relaxed);
+                        break; /* children run inline, the rest isn't needed */
+                    }
+
+                    tasks[i].start(*this, i);
+                }
+
+                return gate.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            std::experimental::coroutine_handle<> finish(std::size_t index) noexcept override {
+                std::experimental::coroutine_handle<> next = std::experimental::noop_coroutine();
+
+                if (!finished.exchange(true, std::memory_order_acq_rel)) {
+                    winner = index;
+
+                    if (gate.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        next = parent;
+                    }
+                }
+
+                release();
+                return next;
+            }
+
+            /* frame of finished child is destroyed here too, it's already suspended */
+            void release() noexcept {
+                if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete this;
+                }
+            }
+
+            std::vector<Lazy<T>> lazies;
+            std::vector<GroupTask> tasks;
+            ThreadPool* pool;
+
+            std::atomic<std::size_t> count;
+            std::atomic<int> gate;
+            std::atomic<bool> finished;
+            std::size_t winner;
+            std::experimental::coroutine_handle<> parent;
+        };
+
+        Group* group;
+    };
+
+    /* co_await whenAny(...) resumes with the first finished lazy, on workers of pool when it's set */
+    template<typename T>
+    WhenAnyAwaitable<T> whenAny(ThreadPool* pool, std::vector<Lazy<T>> lazies) {
+        if (lazies.empty()) {
+            throw std::invalid_argument("whenAny requires at least one lazy");
+        }
+
+        return WhenAnyAwaitable<T>(pool, std::move(lazies));
+    }
+
+    template<typename T>
+    WhenAnyAwaitable<T> whenAny(std::vector<Lazy<T>> lazies) {
+        return whenAny(nullptr, std::move(lazies));
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BufferPool.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace kl::fs {
+
+    void AlignedDeleter::operator()(std::uint8_t* data) const {
+        std::free(data);
+    }
+
+    static AlignedBuffer allocateAligned(std::size_t size, std::size_t alignment) {
+        void* data = nullptr;
+
+        if (::posix_memalign(&data, std::max(alignment, sizeof(void*)), size) != 0) {
+            throw std::bad_alloc();
+        }
+
+        return AlignedBuffer(static_cast<std::uint8_t*>(data));
+    }
+
+    PooledBuffer::~PooledBuffer() {
+        reset();
+    }
+
+    PooledBuffer::PooledBuffer(PooledBuffer&& other) noexcept
+        : pool(other.pool)
+        , data(std::move(other.data))
+        , size_(other.size_)
+        , alignment_(other.alignment_) {
+        other.pool = nullptr;
+        other.size_ = 0;
+        other.alignment_ = 0;
+    }
+
+    PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept {
+        if (std::addressof(other) != this) {
+            reset();
+
+            pool = other.pool;
+            data = std::move(other.data);
+            size_ = other.size_;
+            alignment_ = other.alignment_;
+
+            other.pool = nullptr;
+            other.size_ = 0;
+            other.alignment_ = 0;
+        }
+
+        return *this;
+    }
+
+    void PooledBuffer::reset() {
+        if (pool != nullptr && data != nullptr) {
+            pool->release(std::move(data), size_, alignment_);
+        }
+
+        pool = nullptr;
+        data.reset();
+        size_ = 0;
+        alignment_ = 0;
+    }
+
+    BufferPool::BufferPool(std::size_t maxBuffers) : maxBuffers(maxBuffers) {
+        buffers.reserve(maxBuffers);
+    }
+
+    PooledBuffer BufferPool::acquire(std::size_t size, std::size_t alignment) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto best = buffers.end();
+
+            for (auto it = buffers.begin(); it != buffers.end(); ++it) {
+                if (it->size >= size && it->alignment >= alignment &&
+                    (best == buffers.end() || it->size < best->size)) {
+                    best = it;
+                }
+            }
+
+            if (best != buffers.end()) {
+                Entry entry = std::move(*best);
+                buffers.erase(best);
+
+                return PooledBuffer(*this, std::move(entry.data), entry.size, entry.alignment);
+            }
+        }
+
+        return PooledBuffer(*this, allocateAligned(size, alignment), size, alignment);
+    }
+
+    void BufferPool::release(AlignedBuffer data, std::size_t size, std::size_t alignment) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (buffers.size() < maxBuffers) {
+            buffers.push_back({size, alignment, std::move(data)});
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace kl::fs {
+
+    struct AlignedDeleter final {
+        void operator()(std::uint8_t* data) const;
+    };
+
+    using AlignedBuffer = std::unique_ptr<std::uint8_t[], AlignedDeleter>;
+
+    class BufferPool;
+
+    class PooledBuffer final {
+    public:
+        PooledBuffer() noexcept : pool(nullptr), size_(0), alignment_(0) {}
+        PooledBuffer(BufferPool& pool, AlignedBuffer data, std::size_t size, std::size_t alignment) noexcept
+            : pool(&pool), data(std::move(data)), size_(size), alignment_(alignment) {}
+        ~PooledBuffer();
+
+        PooledBuffer(const PooledBuffer&) = delete;
+        PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+        PooledBuffer(PooledBuffer&& other) noexcept;
+        PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+
+        std::uint8_t* get() const noexcept { return data.get(); }
+        std::size_t size() const noexcept { return size_; }
+        std::size_t alignment() const noexcept { return alignment_; }
+
+        explicit operator bool() const noexcept { return data != nullptr; }
+
+        void reset();
+
+    private:
+        BufferPool* pool;
+        AlignedBuffer data;
+        std::size_t size_;
+        std::size_t alignment_;
+    };
+
+    class BufferPool final {
+    public:
+        explicit BufferPool(std::size_t maxBuffers);
+        ~BufferPool() = default;
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        static constexpr std::size_t DEFAULT_ALIGNMENT = 64;
+
+        /*
+         * Buffer with capacity at least size, reused from pool when possible.
+         * Alignment must be power of two, e.g. logical block size for O_DIRECT.
+         */
+        PooledBuffer acquire(std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT);
+
+    private:
+        friend class PooledBuffer;
+
+        void release(AlignedBuffer data, std::size_t size, std::size_t alignment);
+
+        struct Entry final {
+            std::size_t size;
+            std::size_t alignment;
+            AlignedBuffer data;
+        };
+
+        std::size_t maxBuffers;
+        std::mutex mutex;
+        std::vector<Entry> buffers;
+    };
+}
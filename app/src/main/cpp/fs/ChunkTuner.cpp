@@ -0,0 +1,196 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ChunkTuner.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "FileUtil.hpp"
+#include <logging/Logging.hpp>
+#include <util/strings/StringUtil.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::strings;
+
+    static constexpr const char* TAG = "ChunkTuner-JNI";
+    /* chunk, which is only slightly slower than the best one, is preferred for its smaller buffer */
+    static constexpr double TOLERANCE = 1.05;
+
+    /* unnamed file in filesystem of directory, named one is unlinked at once when O_TMPFILE isn't supported */
+    static UniqueFd openTemporaryFile(int directoryFd) {
+#if defined(O_TMPFILE)
+        if (int fd = ::openat(directoryFd, ".", O_TMPFILE | O_RDWR | O_CLOEXEC, 0600); fd != -1) {
+            return UniqueFd(fd);
+        }
+#endif
+        std::string name = ".";
+        name += randomBuffer(16);
+        UniqueFd fd(::openat(directoryFd, name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600));
+
+        if (fd) {
+            ::unlinkat(directoryFd, name.c_str(), 0);
+        }
+
+        return fd;
+    }
+
+    void ChunkTuner::setCachePath(const std::filesystem::path& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        cachePath = path;
+        load();
+    }
+
+    std::uint32_t ChunkTuner::chunkSize(BufferPool& pool, int directoryFd, dev_t device) {
+        /* calibration runs under lock, so workers of one directory erase wait for the first one */
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (auto iterator = chunkSizes.find(device); iterator != chunkSizes.end()) {
+            return iterator->second;
+        }
+
+        std::uint32_t size = 0;
+
+        if (auto result = calibrate(pool, directoryFd); result.hasValue()) {
+            size = result.value();
+            log::debug(TAG, "Calibrate device %ju: chunk %u bytes", static_cast<std::uintmax_t>(device), size);
+        } else {
+            log::info(TAG, "Can't calibrate device %ju: %s", static_cast<std::uintmax_t>(device),
+                      result.error().message.get().c_str());
+        }
+
+        /* failed device isn't persisted, it is calibrated again after restart */
+        chunkSizes.emplace(device, size);
+
+        if (size != 0) {
+            store();
+        }
+
+        return size;
+    }
+
+    Result<std::uint32_t, FileError> ChunkTuner::calibrate(BufferPool& pool, int directoryFd) {
+        UniqueFd fd = openTemporaryFile(directoryFd);
+
+        if (!fd) {
+            return FileError("Can't create calibration file, error %s", ::strerror(errno));
+        }
+
+        PooledBuffer buffer = pool.acquire(CANDIDATE_SIZES.back());
+        std::memset(buffer.get(), 0x5A, CANDIDATE_SIZES.back());
+
+        /* all candidates overwrite allocated blocks as erase does */
+        if (::fallocate(fd.get(), 0, 0, static_cast<off_t>(REGION_SIZE)) == -1 && errno == ENOSPC) {
+            return FileError("Can't allocate calibration file, error %s", ::strerror(errno));
+        }
+
+        std::array<double, CANDIDATE_SIZES.size()> seconds = {};
+        seconds.fill(std::numeric_limits<double>::max());
+
+        for (int round = 0; round < COUNT_ROUNDS; ++round) {
+            for (std::size_t i = 0; i < CANDIDATE_SIZES.size(); ++i) {
+                auto beginTime = std::chrono::steady_clock::now();
+
+                if (auto result = writePattern(fd.get(), buffer.get(), CANDIDATE_SIZES[i], 0, REGION_SIZE);
+                    result.hasError()) {
+                    return static_cast<FileError>(result.error());
+                }
+
+                if (::fdatasync(fd.get()) == -1) {
+                    return FileError("Can't sync calibration file, error %s", ::strerror(errno));
+                }
+
+                auto endTime = std::chrono::steady_clock::now();
+                seconds[i] = std::min(seconds[i], std::chrono::duration<double>(endTime - beginTime).count());
+            }
+        }
+
+        const double bestSeconds = *std::min_element(seconds.begin(), seconds.end());
+
+        for (std::size_t i = 0; i < CANDIDATE_SIZES.size(); ++i) {
+            log::debug(TAG, "Chunk %u: %.2f MB/s", CANDIDATE_SIZES[i],
+                       seconds[i] > 0.0 ? static_cast<double>(REGION_SIZE) / 1_mb / seconds[i] : 0.0);
+        }
+
+        for (std::size_t i = 0; i < CANDIDATE_SIZES.size(); ++i) {
+            if (seconds[i] <= bestSeconds * TOLERANCE) {
+                return CANDIDATE_SIZES[i];
+            }
+        }
+
+        return CANDIDATE_SIZES.back();
+    }
+
+    /* cache file has line "device chunkSize" per filesystem */
+    void ChunkTuner::load() {
+        std::ifstream input(cachePath);
+        std::uintmax_t device = 0;
+        std::uint32_t size = 0;
+
+        while (input >> device >> size) {
+            if (std::find(CANDIDATE_SIZES.begin(), CANDIDATE_SIZES.end(), size) != CANDIDATE_SIZES.end()) {
+                chunkSizes[static_cast<dev_t>(device)] = size;
+            }
+        }
+    }
+
+    void ChunkTuner::store() {
+        if (cachePath.empty()) {
+            return;
+        }
+
+        std::filesystem::path temporaryPath = cachePath;
+        temporaryPath += ".tmp";
+
+        {
+            std::ofstream output(temporaryPath, std::ios::trunc);
+
+            for (const auto& [device, size] : chunkSizes) {
+                if (size != 0) {
+                    output << static_cast<std::uintmax_t>(device) << ' ' << size << '\n';
+                }
+            }
+
+            if (!output) {
+                log::error(TAG, "Can't write chunk cache %s", temporaryPath.c_str());
+                return;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(temporaryPath, cachePath, errorCode);
+
+        if (errorCode) {
+            log::error(TAG, "Can't replace chunk cache %s: %s", cachePath.c_str(), errorCode.message().c_str());
+        }
+    }
+}
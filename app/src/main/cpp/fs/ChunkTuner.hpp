@@ -0,0 +1,78 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <sys/types.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+#include "BufferPool.hpp"
+#include "FileError.hpp"
+#include "FileUnit.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+    using fs::literals::operator""_kb;
+    using fs::literals::operator""_mb;
+
+    /*
+     * Picks write chunk size per filesystem. First request for a device writes
+     * the same region of a temporary file with every candidate size, each run
+     * ends with fdatasync, the fastest size is cached by st_dev and persisted.
+     */
+    class ChunkTuner final {
+    public:
+        static constexpr std::array<std::uint32_t, 5> CANDIDATE_SIZES = {64_kb, 256_kb, 1_mb, 4_mb, 8_mb};
+        static constexpr std::uintmax_t REGION_SIZE = 8_mb;
+        static constexpr int COUNT_ROUNDS = 2;
+
+        ChunkTuner() = default;
+        ~ChunkTuner() = default;
+
+        ChunkTuner(const ChunkTuner&) = delete;
+        ChunkTuner& operator=(const ChunkTuner&) = delete;
+
+        /* load cached sizes from file and store new ones there */
+        void setCachePath(const std::filesystem::path& path);
+
+        /* zero when filesystem can't be calibrated, e.g. it has no free space */
+        std::uint32_t chunkSize(BufferPool& pool, int directoryFd, dev_t device);
+
+    private:
+        Result<std::uint32_t, FileError> calibrate(BufferPool& pool, int directoryFd);
+        void load();
+        void store();
+
+    private:
+        std::mutex mutex;
+        std::filesystem::path cachePath;
+        std::unordered_map<dev_t, std::uint32_t> chunkSizes;
+    };
+}
@@ -0,0 +1,192 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DeviceScheduler.hpp"
+
+#include <algorithm>
+
+#include "FileUnit.hpp"
+#include <logging/Logging.hpp>
+
+namespace kl::fs {
+    using fs::literals::operator""_mb;
+
+    static constexpr const char* TAG = "DeviceScheduler-JNI";
+    /* change of rate below it is treated as noise */
+    static constexpr double RATE_THRESHOLD = 0.1;
+
+    DeviceScheduler::DeviceScheduler(std::size_t maxConcurrency)
+        : maxConcurrency(std::max<std::size_t>(maxConcurrency, 1))
+        , stopped(false) {
+    }
+
+    void DeviceScheduler::add(dev_t device, std::size_t file) {
+        auto iterator = std::find_if(queues.begin(), queues.end(), [device](const Queue& queue) {
+            return queue.device == device;
+        });
+
+        if (iterator == queues.end()) {
+            queues.push_back({device, {}, 0, 0, 0, -1, {}, 0, 0, {}, 0.0, 0.0});
+            iterator = std::prev(queues.end());
+
+            /* new device takes its share from others, limits are climbing down from it */
+            const std::size_t share = std::max<std::size_t>(maxConcurrency / queues.size(), 1);
+
+            for (auto& queue : queues) {
+                queue.limit = share;
+            }
+        }
+
+        iterator->files.push_back(file);
+    }
+
+    std::optional<DeviceBatch> DeviceScheduler::acquire() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (!stopped) {
+            const bool hasFiles = std::any_of(queues.begin(), queues.end(), [](const Queue& queue) {
+                return queue.next < queue.files.size();
+            });
+
+            if (!hasFiles) {
+                break;
+            }
+
+            if (auto index = chooseQueue(); index.has_value()) {
+                Queue& queue = queues[*index];
+                const std::size_t begin = queue.next;
+                const std::size_t count = std::min(BATCH_SIZE, queue.files.size() - begin);
+                const auto now = std::chrono::steady_clock::now();
+
+                if (queue.windowBegin == std::chrono::steady_clock::time_point{}) {
+                    queue.windowBegin = now;
+                }
+
+                queue.next += count;
+                ++queue.active;
+
+                return DeviceBatch{*index, queue.files.data() + begin, count, now};
+            }
+
+            condition.wait(lock);
+        }
+
+        return std::nullopt;
+    }
+
+    void DeviceScheduler::release(const DeviceBatch& batch, std::uintmax_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Queue& queue = queues[batch.queue];
+            const auto now = std::chrono::steady_clock::now();
+
+            --queue.active;
+            queue.windowWork += bytes + batch.countFiles * FILE_COST;
+            queue.windowLatency += now - batch.beginTime;
+            ++queue.windowBatches;
+
+            if (queue.windowBatches >= WINDOW_BATCHES * queue.limit) {
+                tune(queue, now);
+            }
+        }
+
+        condition.notify_all();
+    }
+
+    void DeviceScheduler::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+
+        condition.notify_all();
+    }
+
+    std::optional<std::size_t> DeviceScheduler::chooseQueue() const {
+        std::optional<std::size_t> result;
+
+        for (std::size_t i = 0; i < queues.size(); ++i) {
+            const Queue& queue = queues[i];
+
+            if (queue.next == queue.files.size() || queue.active >= queue.limit) {
+                continue;
+            }
+
+            /* compare active / limit of both queues without division */
+            if (!result.has_value() || queue.active * queues[*result].limit < queues[*result].active * queue.limit) {
+                result = i;
+            }
+        }
+
+        return result;
+    }
+
+    /*
+     * Hill climbing on rate of the device: limit keeps moving while rate grows,
+     * steps back and settles when rate drops or doesn't change. Settled queue
+     * moves again only when rate of the device changes noticeably. When rate
+     * stays within noise, but batches take noticeably longer, extra workers only
+     * wait in the device queue, so it is treated as drop of rate.
+     */
+    void DeviceScheduler::tune(Queue& queue, std::chrono::steady_clock::time_point now) {
+        const double seconds = std::chrono::duration<double>(now - queue.windowBegin).count();
+        const double rate = seconds > 0.0 ? static_cast<double>(queue.windowWork) / seconds : 0.0;
+        const double latency = std::chrono::duration<double, std::milli>(queue.windowLatency).count() /
+                               static_cast<double>(queue.windowBatches);
+        const std::size_t previousLimit = queue.limit;
+
+        const bool faster = rate > queue.lastRate * (1.0 + RATE_THRESHOLD);
+        const bool stalled = !faster && queue.lastLatency > 0.0 && latency > queue.lastLatency * (1.0 + RATE_THRESHOLD);
+        const bool slower = rate < queue.lastRate * (1.0 - RATE_THRESHOLD) || stalled;
+        int step = 0;
+
+        if (queue.lastRate == 0.0) {
+            step = queue.direction;
+        } else if (queue.direction == 0) {
+            step = faster ? 1 : (slower ? -1 : 0);
+            queue.direction = step;
+        } else if (faster) {
+            step = queue.direction;
+        } else {
+            step = slower ? -queue.direction : 0;
+            queue.direction = 0;
+        }
+
+        if (step > 0 && queue.limit < maxConcurrency) {
+            ++queue.limit;
+        } else if (step < 0 && queue.limit > 1) {
+            --queue.limit;
+        }
+
+        log::debug(TAG, "Device %ju: %.1f MB/s, batch %.1f ms, workers %zu -> %zu",
+                   static_cast<std::uintmax_t>(queue.device), rate / 1_mb, latency, previousLimit, queue.limit);
+
+        queue.lastRate = rate;
+        queue.lastLatency = latency;
+        queue.windowBegin = now;
+        queue.windowWork = 0;
+        queue.windowBatches = 0;
+        queue.windowLatency = {};
+    }
+}
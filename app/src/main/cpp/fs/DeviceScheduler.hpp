@@ -0,0 +1,104 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace kl::fs {
+
+    /* files of one device taken by worker, pointer stays valid while scheduler is alive */
+    struct DeviceBatch final {
+        std::size_t queue;
+        const std::size_t* files;
+        std::size_t countFiles;
+        std::chrono::steady_clock::time_point beginTime;
+    };
+
+    /*
+     * Bounded queue of files per device. Each queue has own limit of workers,
+     * it starts at equal share of all workers and moves while measured rate of
+     * the device grows, steps back when rate drops or batches get slower, so
+     * slow card isn't thrashed and fast storage is kept busy from the start.
+     * Free worker takes batch from queue with the lowest share of its limit.
+     */
+    class DeviceScheduler final {
+    public:
+        static constexpr std::size_t BATCH_SIZE = 32;
+        /* batches per worker in one measurement window */
+        static constexpr std::size_t WINDOW_BATCHES = 4;
+        /* even empty file costs metadata writes, so it's counted as one block */
+        static constexpr std::uintmax_t FILE_COST = 4096;
+
+        explicit DeviceScheduler(std::size_t maxConcurrency);
+        ~DeviceScheduler() = default;
+
+        DeviceScheduler(const DeviceScheduler&) = delete;
+        DeviceScheduler& operator=(const DeviceScheduler&) = delete;
+
+        /* files are added before workers start and keep their order inside device */
+        void add(dev_t device, std::size_t file);
+
+        /* wait while all devices with files are at their limits, empty when no files left */
+        std::optional<DeviceBatch> acquire();
+        void release(const DeviceBatch& batch, std::uintmax_t bytes);
+        void stop();
+
+        std::size_t countDevices() const noexcept { return queues.size(); }
+
+    private:
+        struct Queue final {
+            dev_t device;
+            std::vector<std::size_t> files;
+            std::size_t next;
+            std::size_t active;
+            std::size_t limit;
+            int direction;
+
+            std::chrono::steady_clock::time_point windowBegin;
+            std::uintmax_t windowWork;
+            std::size_t windowBatches;
+            std::chrono::steady_clock::duration windowLatency;
+            double lastRate;
+            double lastLatency;
+        };
+
+        std::optional<std::size_t> chooseQueue() const;
+        void tune(Queue& queue, std::chrono::steady_clock::time_point now);
+
+    private:
+        std::size_t maxConcurrency;
+        std::vector<Queue> queues;
+        bool stopped;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+}
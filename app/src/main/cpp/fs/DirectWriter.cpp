@@ -0,0 +1,141 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DirectWriter.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+namespace kl::fs {
+    static constexpr std::size_t MIN_DIRECT_ALIGNMENT = 512;
+
+    DirectWriter::DirectWriter(int directFd, int bufferedFd, std::size_t alignment)
+        : directFd(directFd)
+        , bufferedFd(bufferedFd)
+        , alignment_(alignment) {
+    }
+
+    DirectWriter::~DirectWriter() {
+        if (directFd != -1) {
+            ::close(directFd);
+        }
+    }
+
+    Result<std::unique_ptr<DirectWriter>, FileError> DirectWriter::open(int bufferedFd, std::size_t blockSize) {
+        /*
+         * Filesystem block size is a multiple of logical block size of the device,
+         * so it is safe alignment for both offsets and memory of direct writes.
+         */
+        std::size_t alignment = std::bit_ceil(std::max(blockSize, MIN_DIRECT_ALIGNMENT));
+
+        /* magic link of descriptor reopens the same inode, path isn't resolved again */
+        const std::string fdPath = "/proc/self/fd/" + std::to_string(bufferedFd);
+        int directFd = ::open(fdPath.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+
+        if (directFd == -1) {
+            return FileError("Can't reopen file with O_DIRECT, error %s", ::strerror(errno));
+        }
+
+        return std::unique_ptr<DirectWriter>(new DirectWriter(directFd, bufferedFd, alignment));
+    }
+
+    Result<std::uintmax_t, FileError> DirectWriter::writeRange(const std::uint8_t* buffer, std::size_t chunkSize,
+                                                               std::uintmax_t offset, std::uintmax_t length) {
+        const std::uintmax_t begin = offset;
+        const std::uintmax_t end = offset + length;
+        const std::uintmax_t alignedEnd = end - end % alignment_;
+
+        if (chunkSize % alignment_ != 0 || reinterpret_cast<std::uintptr_t>(buffer) % alignment_ != 0) {
+            return FileError("Buffer isn't aligned to %zu bytes for direct write", alignment_);
+        }
+
+        if (offset % alignment_ != 0) {
+            return FileError("Offset %ju isn't aligned to %zu bytes for direct write", offset, alignment_);
+        }
+
+        while (offset < alignedEnd) {
+            const auto size = static_cast<std::size_t>(std::min<std::uintmax_t>(chunkSize, alignedEnd - offset));
+            const ssize_t written = ::pwrite(directFd, buffer, size, static_cast<off_t>(offset));
+
+            if (written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return FileError("Fail direct write to file, error %s", ::strerror(errno));
+            }
+
+            if (static_cast<std::size_t>(written) % alignment_ != 0) {
+                return FileError("Fail direct write to file, short write of %zd bytes", written);
+            }
+
+            offset += static_cast<std::uintmax_t>(written);
+        }
+
+        /* last aligned chunk could be partial, so tail continues inside the chunk, not from its start */
+        if (offset < end) {
+            const std::uint8_t* tail = buffer + (offset - begin) % chunkSize;
+
+            if (auto result = writeTail(tail, offset, static_cast<std::size_t>(end - offset)); result.hasValue()) {
+                offset = result.value();
+            } else {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        return offset - begin;
+    }
+
+    Result<std::uintmax_t, FileError> DirectWriter::writeTail(const std::uint8_t* buffer, std::uintmax_t offset,
+                                                              std::size_t size) {
+        std::size_t written = 0;
+
+        while (written < size) {
+            const ssize_t count = ::pwrite(bufferedFd, buffer + written, size - written,
+                                           static_cast<off_t>(offset + written));
+
+            if (count == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return FileError("Fail write tail to file, error %s", ::strerror(errno));
+            }
+
+            written += static_cast<std::size_t>(count);
+        }
+
+        /* tail is less than one block: write it back now and drop it from page cache */
+        ::sync_file_range(bufferedFd, static_cast<off_t>(offset), static_cast<off_t>(size),
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(bufferedFd, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+
+        return offset + written;
+    }
+}
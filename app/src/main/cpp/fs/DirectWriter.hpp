@@ -0,0 +1,70 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "FileError.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+
+    /*
+     * Overwrite through a second descriptor opened with O_DIRECT, so passes
+     * don't go through page cache. Chunks must be aligned to the alignment
+     * of the file, an unaligned tail is written through the buffered descriptor
+     * and dropped from page cache right after.
+     */
+    class DirectWriter final {
+    public:
+        ~DirectWriter();
+
+        DirectWriter(const DirectWriter&) = delete;
+        DirectWriter& operator=(const DirectWriter&) = delete;
+
+        /* reopen buffered descriptor with O_DIRECT, error when filesystem doesn't support it */
+        static Result<std::unique_ptr<DirectWriter>, FileError> open(int bufferedFd, std::size_t blockSize);
+
+        std::size_t alignment() const { return alignment_; }
+
+        /* offset must be aligned, unaligned end of range is written as tail */
+        Result<std::uintmax_t, FileError> writeRange(const std::uint8_t* buffer, std::size_t chunkSize,
+                                                     std::uintmax_t offset, std::uintmax_t length);
+
+    private:
+        DirectWriter(int directFd, int bufferedFd, std::size_t alignment);
+
+        Result<std::uintmax_t, FileError> writeTail(const std::uint8_t* buffer, std::uintmax_t offset,
+                                                    std::size_t size);
+
+    private:
+        int directFd;
+        int bufferedFd;
+        std::size_t alignment_;
+    };
+}
@@ -0,0 +1,175 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DirectoryEraser.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include "EraseSession.hpp"
+#include <logging/Logging.hpp>
+
+namespace kl::fs {
+    static constexpr const char* TAG = "DirectoryEraser-JNI";
+
+    DirectoryEraser::DirectoryEraser(std::size_t countThreads)
+        : countThreads(countThreads != 0 ? countThreads : std::max(1u, std::thread::hardware_concurrency()))
+        , pool(this->countThreads)
+        , scheduler(this->countThreads)
+        , countFiles(0)
+        , countBytes(0)
+        , failed(false) {
+    }
+
+    Result<EraseStatistics, FileError> DirectoryEraser::erase(const std::filesystem::path& folder, OverwriteMode mode,
+                                                              const EraseOptions& options, bool recursive) {
+        auto beginTime = std::chrono::steady_clock::now();
+
+        if (auto result = walker.walk(folder, recursive); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        const auto& files = walker.files();
+        const auto& directories = walker.directories();
+
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            scheduler.add(directories[files[i].directory].device, i);
+        }
+
+        const std::size_t countWorkers = std::min(countThreads, std::max<std::size_t>(files.size(), 1));
+        std::vector<std::thread> workers;
+        workers.reserve(countWorkers);
+
+        log::debug(TAG, "Erase %zu files on %zu devices with %zu threads",
+                   files.size(), scheduler.countDevices(), countWorkers);
+
+        for (std::size_t i = 0; i < countWorkers; ++i) {
+            workers.emplace_back(&DirectoryEraser::eraseFiles, this, mode, std::cref(options));
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        if (error.has_value()) {
+            return std::move(*error);
+        }
+
+        if (recursive) {
+            if (auto result = walker.removeDirectories(); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        auto endTime = std::chrono::steady_clock::now();
+
+        EraseStatistics statistics;
+        statistics.countFiles = countFiles.load();
+        statistics.countBytes = countBytes.load();
+        statistics.duration = endTime - beginTime;
+
+        return statistics;
+    }
+
+    /*
+     * Workers take batches of one device from scheduler, files of a batch mostly
+     * share directory, so its descriptor is opened once and files are opened
+     * relative to it.
+     */
+    void DirectoryEraser::eraseFiles(OverwriteMode mode, const EraseOptions& options) {
+        const auto& files = walker.files();
+
+        /* telemetry isn't shared by sessions, each worker merges own one at the end */
+        EraseTelemetry telemetry;
+        EraseOptions sessionOptions = options;
+
+        if (options.telemetry != nullptr) {
+            sessionOptions.telemetry = &telemetry;
+        }
+
+        EraseSession session(pool);
+        UniqueFd directory;
+        std::size_t directoryIndex = 0;
+        std::uintmax_t erasedFiles = 0;
+        std::uintmax_t erasedBytes = 0;
+
+        while (auto batch = scheduler.acquire()) {
+            std::uintmax_t batchBytes = 0;
+
+            for (std::size_t i = 0; i < batch->countFiles && !failed.load(std::memory_order_relaxed); ++i) {
+                const WalkFile& entry = files[batch->files[i]];
+
+                if (!directory || entry.directory != directoryIndex) {
+                    directoryIndex = entry.directory;
+
+                    if (auto result = walker.openDirectory(directoryIndex); result.hasValue()) {
+                        directory = std::move(result.value());
+                    } else {
+                        directory.reset();
+                        failWith(std::move(result.error()));
+                        break;
+                    }
+                }
+
+                if (auto result = session.erase(directory.get(), entry.name, mode, sessionOptions); result.hasValue()) {
+                    batchBytes += result.value();
+                    ++erasedFiles;
+                } else {
+                    failWith(std::move(result.error()));
+                    break;
+                }
+            }
+
+            scheduler.release(*batch, batchBytes);
+            erasedBytes += batchBytes;
+        }
+
+        /* files of last BATCH_SYNC batch are still waiting for sync */
+        if (auto result = session.syncBatch(); result.hasError()) {
+            failWith(std::move(result.error()));
+        }
+
+        countFiles.fetch_add(erasedFiles, std::memory_order_relaxed);
+        countBytes.fetch_add(erasedBytes, std::memory_order_relaxed);
+
+        if (options.telemetry != nullptr) {
+            std::lock_guard<std::mutex> lock(telemetryMutex);
+            options.telemetry->merge(telemetry);
+        }
+    }
+
+    void DirectoryEraser::failWith(FileError&& newError) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+
+        if (!error.has_value()) {
+            error.emplace(std::move(newError));
+            failed.store(true, std::memory_order_relaxed);
+            scheduler.stop();
+        }
+    }
+}
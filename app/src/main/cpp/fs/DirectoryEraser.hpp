@@ -23,12 +23,18 @@
  */
 #pragma once
 
+#include <atomic>
 #include <filesystem>
-#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 
-#include "EraseEntry.hpp"
+#include "BufferPool.hpp"
+#include "DeviceScheduler.hpp"
+#include "DirectoryWalker.hpp"
+#include "EraseOptions.hpp"
+#include "EraseStatistics.hpp"
 #include "OverwriteMode.hpp"
-#include "FileUtil.hpp"
 #include "FileError.hpp"
 
 #include <util/error/Result.hpp>
@@ -36,34 +42,34 @@
 namespace kl::fs {
     using namespace kl::util::error;
 
-    class FileEraser final {
-    private:
-        FileEraser() = default;
-        ~FileEraser() = default;
-
+    class DirectoryEraser final {
     public:
-        static FileEraser& instance();
+        /* zero count of threads means use all hardware threads */
+        explicit DirectoryEraser(std::size_t countThreads);
+        ~DirectoryEraser() = default;
 
-        Result<void, FileError> init(const std::filesystem::path& path, OverwriteMode newMode);
+        DirectoryEraser(const DirectoryEraser&) = delete;
+        DirectoryEraser& operator=(const DirectoryEraser&) = delete;
 
-        Result<void, FileError> checkPermission();
-        Result<void, FileError> removeFile();
-        Result<void, FileError> overwriteFile();
-        Result<void, FileError> truncateFile(std::size_t size);
+        Result<EraseStatistics, FileError> erase(const std::filesystem::path& folder, OverwriteMode mode,
+                                                 const EraseOptions& options, bool recursive);
 
     private:
-        void showPermission(std::filesystem::perms permission);
-
-        Result<std::size_t, FileError> overwriteByte(int pass, std::uint8_t symbol);
-        Result<std::size_t, FileError> overwriteRandom(int pass);
-        Result<std::size_t, FileError> overwriteBuffer(int pass);
-        Result<std::size_t, FileError> writeBuffer(std::size_t count, std::size_t tail);
+        void eraseFiles(OverwriteMode mode, const EraseOptions& options);
+        void failWith(FileError&& error);
 
     private:
-        std::unique_ptr<std::uint8_t[]> buffer;
-        EraseEntry eraseEntry;
+        std::size_t countThreads;
+        BufferPool pool;
+        DirectoryWalker walker;
+        DeviceScheduler scheduler;
+
+        std::atomic<std::uintmax_t> countFiles;
+        std::atomic<std::uintmax_t> countBytes;
+        std::atomic<bool> failed;
 
-        std::filesystem::path path;
-        FileUniquePtr file;
+        std::mutex errorMutex;
+        std::optional<FileError> error;
+        std::mutex telemetryMutex;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,285 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DirectoryWalker.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "FileUtil.hpp"
+#include <logging/Logging.hpp>
+
+namespace kl::fs {
+    static constexpr const char* TAG = "DirectoryWalker-JNI";
+    static constexpr int DIRECTORY_FLAGS = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+
+    /* opened directory and range of its subdirectories, which aren't visited yet */
+    struct WalkFrame final {
+        UniqueFd fd;
+        std::size_t index;
+        std::size_t next;
+        std::size_t end;
+    };
+
+    static bool isDotEntry(const char* name) {
+        return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+    }
+
+    DirectoryWalker::DirectoryWalker(std::size_t bufferSize)
+        : buffer(bufferSize)
+        , countSkipped_(0) {
+    }
+
+    Result<void, FileError> DirectoryWalker::walk(const std::filesystem::path& root, bool recursive) {
+        directories_.clear();
+        files_.clear();
+        countSkipped_ = 0;
+
+        UniqueFd rootFd(::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+
+        if (!rootFd) {
+            switch (errno) {
+            case ENOENT:
+                return FileError("Directory doesn't exist");
+            case ENOTDIR:
+                return FileError("Path doesn't directory");
+            default:
+                return FileError("Can't open directory %s, error %s", root.c_str(), ::strerror(errno));
+            }
+        }
+
+        directories_.push_back({0, 1, 1, 0, 0, root.filename(), root.string()});
+
+        std::vector<WalkFrame> stack;
+
+        if (auto result = readDirectory(rootFd.get(), 0, recursive); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        directories_[0].endChildren = directories_.size();
+        stack.push_back({std::move(rootFd), 0, 1, directories_.size()});
+
+        while (!stack.empty()) {
+            WalkFrame& top = stack.back();
+
+            if (top.next == top.end) {
+                stack.pop_back();
+                continue;
+            }
+
+            const std::size_t index = top.next++;
+            UniqueFd fd(::openat(top.fd.get(), directories_[index].name.c_str(), DIRECTORY_FLAGS));
+
+            if (!fd) {
+                return FileError("Can't open directory %s, error %s", directories_[index].path.c_str(), ::strerror(errno));
+            }
+
+            const std::size_t begin = directories_.size();
+
+            if (auto result = readDirectory(fd.get(), index, recursive); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+
+            directories_[index].beginChildren = begin;
+            directories_[index].endChildren = directories_.size();
+            stack.push_back({std::move(fd), index, begin, directories_.size()});
+        }
+
+        log::debug(TAG, "Walk %s: %zu files, %zu directories, %zu skipped", root.c_str(),
+                   files_.size(), directories_.size(), countSkipped_);
+
+        return {};
+    }
+
+    Result<void, FileError> DirectoryWalker::readDirectory(int fd, std::size_t index, bool recursive) {
+        const std::string parentPath = directories_[index].path;
+        struct stat directoryInfo = {};
+
+        if (::fstat(fd, &directoryInfo) == -1) {
+            return FileError("Can't get status of directory %s, error %s", parentPath.c_str(), ::strerror(errno));
+        }
+
+        directories_[index].device = directoryInfo.st_dev;
+        directories_[index].inode = directoryInfo.st_ino;
+
+        while (true) {
+            const long count = ::syscall(__NR_getdents64, fd, buffer.data(), buffer.size());
+
+            if (count == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                return FileError("Can't read directory %s, error %s", parentPath.c_str(), ::strerror(errno));
+            }
+
+            if (count == 0) {
+                break;
+            }
+
+            for (long offset = 0; offset < count;) {
+                const auto* entry = reinterpret_cast<const struct dirent64*>(buffer.data() + offset);
+                offset += entry->d_reclen;
+
+                if (isDotEntry(entry->d_name)) {
+                    continue;
+                }
+
+                unsigned char type = entry->d_type;
+
+                if (type == DT_UNKNOWN) {
+                    struct stat entryInfo = {};
+
+                    if (::fstatat(fd, entry->d_name, &entryInfo, AT_SYMLINK_NOFOLLOW) == -1) {
+                        if (errno == ENOENT) {
+                            continue; /* removed while walking */
+                        }
+
+                        return FileError("Can't get status of %s/%s, error %s",
+                                         parentPath.c_str(), entry->d_name, ::strerror(errno));
+                    }
+
+                    type = IFTODT(entryInfo.st_mode);
+                }
+
+                if (type == DT_REG) {
+                    files_.push_back({index, entry->d_name});
+                } else if (type == DT_DIR) {
+                    if (recursive) {
+                        directories_.push_back({index, 0, 0, 0, 0, entry->d_name, parentPath + '/' + entry->d_name});
+                    }
+                } else {
+                    log::debug(TAG, "Skip %s/%s, it isn't regular file", parentPath.c_str(), entry->d_name);
+                    ++countSkipped_;
+                }
+            }
+        }
+
+        return {};
+    }
+
+    static Result<void, FileError> checkIdentity(int fd, const WalkDirectory& walked) {
+        struct stat directoryInfo = {};
+
+        if (::fstat(fd, &directoryInfo) == -1) {
+            return FileError("Can't get status of directory %s, error %s", walked.path.c_str(), ::strerror(errno));
+        }
+
+        if (directoryInfo.st_dev != walked.device || directoryInfo.st_ino != walked.inode) {
+            return FileError("Directory %s was replaced after walk", walked.path.c_str());
+        }
+
+        return {};
+    }
+
+    /*
+     * Any component of path could be swapped for a symlink after walk. Last one isn't
+     * followed, except root which could be a symlink from the start, and identity of
+     * opened directory must match the walked one.
+     */
+    Result<UniqueFd, FileError> DirectoryWalker::openDirectory(std::size_t index) const {
+        const WalkDirectory& walked = directories_[index];
+        const int flags = index == 0 ? O_RDONLY | O_DIRECTORY | O_CLOEXEC : DIRECTORY_FLAGS;
+        UniqueFd fd(::open(walked.path.c_str(), flags));
+
+        if (!fd) {
+            return FileError("Can't open directory %s, error %s", walked.path.c_str(), ::strerror(errno));
+        }
+
+        if (auto result = checkIdentity(fd.get(), walked); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        return fd;
+    }
+
+    /*
+     * Post-order walk over collected directories: a directory is removed, when
+     * all its subdirectories are visited. Directory with skipped entries stays.
+     */
+    Result<std::size_t, FileError> DirectoryWalker::removeDirectories() {
+        if (directories_.size() <= 1) {
+            return std::size_t{0};
+        }
+
+        auto rootFd = openDirectory(0);
+
+        if (rootFd.hasError()) {
+            return static_cast<FileError>(rootFd.error());
+        }
+
+        std::size_t countRemoved = 0;
+        std::vector<WalkFrame> stack;
+
+        stack.push_back({std::move(rootFd.value()), 0, directories_[0].beginChildren, directories_[0].endChildren});
+
+        while (!stack.empty()) {
+            WalkFrame& top = stack.back();
+
+            if (top.next != top.end) {
+                const std::size_t index = top.next++;
+                UniqueFd fd(::openat(top.fd.get(), directories_[index].name.c_str(), DIRECTORY_FLAGS));
+
+                if (!fd) {
+                    return FileError("Can't open directory %s, error %s",
+                                     directories_[index].path.c_str(), ::strerror(errno));
+                }
+
+                if (auto result = checkIdentity(fd.get(), directories_[index]); result.hasError()) {
+                    return static_cast<FileError>(result.error());
+                }
+
+                stack.push_back({std::move(fd), index,
+                                 directories_[index].beginChildren, directories_[index].endChildren});
+                continue;
+            }
+
+            const std::size_t index = top.index;
+            stack.pop_back();
+
+            if (stack.empty()) {
+                break; /* root stays */
+            }
+
+            if (::unlinkat(stack.back().fd.get(), directories_[index].name.c_str(), AT_REMOVEDIR) == -1) {
+                if (errno != ENOTEMPTY && errno != EEXIST) {
+                    return FileError("Can't remove directory %s, error %s",
+                                     directories_[index].path.c_str(), ::strerror(errno));
+                }
+
+                log::debug(TAG, "Keep directory %s, it isn't empty", directories_[index].path.c_str());
+            } else {
+                ++countRemoved;
+            }
+        }
+
+        return countRemoved;
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "FileError.hpp"
+#include "FileUtil.hpp"
+#include "FileUnit.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+    using fs::literals::operator""_kb;
+
+    /*
+     * Directory found by walk, root has index 0 and is parent of itself.
+     * Its subdirectories are stored in range [beginChildren, endChildren),
+     * device and inode are taken from fstat of directory, its files are on the
+     * same device, and directory reopened by path later is checked against them.
+     */
+    struct WalkDirectory final {
+        std::size_t parent;
+        std::size_t beginChildren;
+        std::size_t endChildren;
+        dev_t device;
+        ino_t inode;
+        std::string name;
+        std::string path;
+    };
+
+    /* regular file, name is relative to its directory */
+    struct WalkFile final {
+        std::size_t directory;
+        std::string name;
+    };
+
+    /*
+     * Walks directory tree with openat and getdents64, type of entry is taken
+     * from d_type, so entry is stat-ed only when filesystem doesn't report it.
+     * Files of one directory are stored next to each other, subdirectories
+     * always follow their parent.
+     */
+    class DirectoryWalker final {
+    public:
+        static constexpr std::size_t DEFAULT_BUFFER_SIZE = 256_kb;
+
+        explicit DirectoryWalker(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+        ~DirectoryWalker() = default;
+
+        DirectoryWalker(const DirectoryWalker&) = delete;
+        DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+
+        /* collect regular files, symlinks and special files are skipped */
+        Result<void, FileError> walk(const std::filesystem::path& root, bool recursive);
+
+        /* reopen walked directory by path, fail when it was replaced after walk */
+        Result<UniqueFd, FileError> openDirectory(std::size_t index) const;
+
+        /* remove subdirectories bottom-up, root and non-empty ones stay, return count of removed */
+        Result<std::size_t, FileError> removeDirectories();
+
+        const std::vector<WalkDirectory>& directories() const noexcept { return directories_; }
+        const std::vector<WalkFile>& files() const noexcept { return files_; }
+        std::size_t countSkipped() const noexcept { return countSkipped_; }
+
+    private:
+        Result<void, FileError> readDirectory(int fd, std::size_t index, bool recursive);
+
+    private:
+        std::vector<char> buffer;
+        std::vector<WalkDirectory> directories_;
+        std::vector<WalkFile> files_;
+        std::size_t countSkipped_;
+    };
+}
@@ -25,6 +25,7 @@
 
 #include <string>
 
+#include "EraseOptions.hpp"
 #include "OverwriteMode.hpp"
 
 namespace kl::fs {
@@ -34,6 +35,7 @@ namespace kl::fs {
         std::uintmax_t fileSize;
         std::uint32_t  bufferSize;
         OverwriteMode mode;
+        EraseOptions options;
 
         EraseEntry() : fileSize(0), bufferSize(0), mode(OverwriteMode::SIMPLE_MODE) {}
         ~EraseEntry() = default;
@@ -0,0 +1,180 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "EraseJournal.hpp"
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include <logging/Logging.hpp>
+
+namespace kl::fs {
+    static constexpr const char* TAG = "EraseJournal-JNI";
+    static constexpr int COUNT_SLOTS = 2;
+
+    /* FNV-1a over record without its checksum */
+    static std::uint32_t checksumOf(const JournalRecord& record) {
+        const auto* data = reinterpret_cast<const std::uint8_t*>(&record);
+        std::uint32_t hash = 2166136261u;
+
+        for (std::size_t i = 0; i < offsetof(JournalRecord, checksum); ++i) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+
+        return hash;
+    }
+
+    static bool isSameFile(const JournalRecord& left, const JournalRecord& right) {
+        return left.device == right.device && left.inode == right.inode && left.generation == right.generation &&
+               left.fileSize == right.fileSize && left.mode == right.mode;
+    }
+
+    Result<void, FileError> JournalFile::commit(std::uint32_t pass, std::uintmax_t offset) {
+        record.sequence++;
+        record.pass = pass;
+        record.offset = offset;
+        record.checksum = checksumOf(record);
+
+        const off_t slotOffset = static_cast<off_t>((record.sequence % COUNT_SLOTS) * sizeof(JournalRecord));
+
+        if (::pwrite(fd.get(), &record, sizeof(record), slotOffset) != static_cast<ssize_t>(sizeof(record))) {
+            return FileError("Can't write journal %s, error %s", path.c_str(), ::strerror(errno));
+        }
+
+        if (::fdatasync(fd.get()) == -1) {
+            return FileError("Can't sync journal %s, error %s", path.c_str(), ::strerror(errno));
+        }
+
+        return {};
+    }
+
+    void JournalFile::remove() {
+        if (!fd) {
+            return;
+        }
+
+        fd.reset();
+
+        if (::unlink(path.c_str()) == -1 && errno != ENOENT) {
+            log::error(TAG, "Can't remove journal %s, error %s", path.c_str(), ::strerror(errno));
+        }
+    }
+
+    void EraseJournal::setDirectory(const std::filesystem::path& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::error_code error;
+
+        std::filesystem::create_directories(path, error);
+
+        if (error) {
+            log::error(TAG, "Can't create journal directory %s, error %s", path.c_str(), error.message().c_str());
+        }
+
+        directory = path;
+    }
+
+    Result<JournalFile, FileError> EraseJournal::open(int fd, const struct stat& fileInfo, OverwriteMode mode) {
+        std::filesystem::path journalDirectory;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            journalDirectory = directory;
+        }
+
+        if (journalDirectory.empty()) {
+            return FileError("Journal directory isn't set");
+        }
+
+        /* generation tells apart a new file, which reuses inode of an erased one */
+        unsigned int generation = 0;
+
+        if (::ioctl(fd, FS_IOC_GETVERSION, &generation) == -1) {
+            generation = 0;
+        }
+
+        char fileName[64] = {};
+        std::snprintf(fileName, sizeof(fileName), "%jx-%jx.journal",
+                      static_cast<std::uintmax_t>(fileInfo.st_dev), static_cast<std::uintmax_t>(fileInfo.st_ino));
+
+        JournalFile journal;
+        journal.path = journalDirectory / fileName;
+        journal.record.magic = MAGIC;
+        journal.record.device = static_cast<std::uint64_t>(fileInfo.st_dev);
+        journal.record.inode = static_cast<std::uint64_t>(fileInfo.st_ino);
+        journal.record.generation = generation;
+        journal.record.fileSize = static_cast<std::uint64_t>(fileInfo.st_size);
+        journal.record.mode = static_cast<std::uint32_t>(mode);
+        journal.fd.reset(::open(journal.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600));
+
+        if (!journal.fd) {
+            return FileError("Can't open journal %s, error %s", journal.path.c_str(), ::strerror(errno));
+        }
+
+        JournalRecord slots[COUNT_SLOTS] = {};
+        const ssize_t count = ::pread(journal.fd.get(), slots, sizeof(slots), 0);
+
+        if (count == -1) {
+            return FileError("Can't read journal %s, error %s", journal.path.c_str(), ::strerror(errno));
+        }
+
+        if (count == 0) {
+            /* new journal must survive crash as well as its records */
+            UniqueFd directoryFd(::open(journalDirectory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+
+            if (!directoryFd || ::fsync(directoryFd.get()) == -1) {
+                return FileError("Can't sync journal directory %s, error %s", journalDirectory.c_str(), ::strerror(errno));
+            }
+        }
+
+        const JournalRecord* latest = nullptr;
+
+        for (int i = 0; i < COUNT_SLOTS; ++i) {
+            const JournalRecord& slot = slots[i];
+
+            if (static_cast<std::size_t>(count) < (i + 1) * sizeof(JournalRecord) || slot.magic != MAGIC ||
+                slot.checksum != checksumOf(slot) || !isSameFile(slot, journal.record)) {
+                continue;
+            }
+
+            if (latest == nullptr || slot.sequence > latest->sequence) {
+                latest = &slot;
+            }
+        }
+
+        if (latest != nullptr) {
+            journal.record = *latest;
+            log::info(TAG, "Resume erase of inode %ju from pass %u at %" PRIu64, static_cast<std::uintmax_t>(fileInfo.st_ino),
+                      latest->pass, latest->offset);
+        }
+
+        return journal;
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+
+#include "FileError.hpp"
+#include "FileUnit.hpp"
+#include "FileUtil.hpp"
+#include "OverwriteMode.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+    using fs::literals::operator""_mb;
+
+    /* one slot of journal, identity of erased file and its last durable point */
+    struct JournalRecord final {
+        std::uint32_t magic;
+        std::uint32_t sequence;
+        std::uint64_t device;
+        std::uint64_t inode;
+        std::uint64_t generation;
+        std::uint64_t fileSize;
+        std::uint64_t offset;
+        std::uint32_t pass;
+        std::uint32_t mode;
+        std::uint32_t reserved;
+        std::uint32_t checksum;
+    };
+
+    static_assert(sizeof(JournalRecord) == 64);
+
+    /*
+     * Journal of one erased file. Record means all passes before its pass are
+     * durable, and its pass is durable up to offset. Two slots are written by
+     * turns, so torn write of one slot leaves the previous point readable.
+     */
+    class JournalFile final {
+    public:
+        JournalFile() = default;
+        ~JournalFile() = default;
+
+        JournalFile(JournalFile&&) = default;
+        JournalFile& operator=(JournalFile&&) = default;
+
+        /* zero pass means nothing is committed yet */
+        std::uint32_t pass() const { return record.pass; }
+        std::uintmax_t offset() const { return record.offset; }
+
+        /* caller syncs data of the file before commit */
+        Result<void, FileError> commit(std::uint32_t pass, std::uintmax_t offset);
+        /* erase is complete, journal isn't needed anymore */
+        void remove();
+
+    private:
+        friend class EraseJournal;
+
+        UniqueFd fd;
+        std::filesystem::path path;
+        JournalRecord record = {};
+    };
+
+    /*
+     * Directory of journals, one per erased file named by its device and inode.
+     * Journal matches the file only when inode generation, size and mode are
+     * the same, otherwise erase starts from the beginning.
+     */
+    class EraseJournal final {
+    public:
+        static constexpr std::uint32_t MAGIC = 0x4641454A; /* FAEJ */
+        /* bytes of a pass between commits, each commit syncs the erased file */
+        static constexpr std::uintmax_t COMMIT_INTERVAL = 64_mb;
+
+        EraseJournal() = default;
+        ~EraseJournal() = default;
+
+        EraseJournal(const EraseJournal&) = delete;
+        EraseJournal& operator=(const EraseJournal&) = delete;
+
+        void setDirectory(const std::filesystem::path& path);
+
+        /* load point of previous run of the same file or start new journal */
+        Result<JournalFile, FileError> open(int fd, const struct stat& fileInfo, OverwriteMode mode);
+
+    private:
+        std::mutex mutex;
+        std::filesystem::path directory;
+    };
+}
@@ -0,0 +1,89 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "ChunkTuner.hpp"
+#include "EraseJournal.hpp"
+#include "EraseProgress.hpp"
+#include "EraseTelemetry.hpp"
+#include "FileUnit.hpp"
+#include "SyncPolicy.hpp"
+#include "WriteBackend.hpp"
+
+namespace kl::fs {
+    using fs::literals::operator""_mb;
+
+    struct EraseOptions final {
+        static constexpr std::uint32_t DEFAULT_QUEUE_DEPTH = 32;
+        static constexpr std::uintmax_t DEFAULT_MMAP_THRESHOLD = 64_mb;
+        static constexpr std::uint32_t DEFAULT_SYNC_BATCH_SIZE = 32;
+        static constexpr std::uintmax_t DEFAULT_RANGE_THRESHOLD = 256_mb;
+
+        WriteBackend backend;
+        std::uint32_t queueDepth;
+        /* AUTO_BACKEND compares mmap and write paths only for files above it */
+        std::uintmax_t mmapThreshold;
+        /* DISCARD_MODE writes one zero pass before punching holes */
+        bool patternPass;
+        /* read back every pass and compare with its pattern */
+        bool verify;
+        /* optional counters and cancel flag, owned by caller */
+        EraseProgress* progress;
+        /* size of write chunk, zero means size of tuner or block size of filesystem */
+        std::uint32_t bufferSize;
+        /* optional calibrated chunk sizes per filesystem, owned by caller */
+        ChunkTuner* chunkTuner;
+        SyncPolicy syncPolicy;
+        /* count of files between syncfs calls of BATCH_SYNC */
+        std::uint32_t syncBatchSize;
+        /* count of threads writing ranges of one file with stdio backend, one disables it */
+        std::uint32_t rangeThreads;
+        /* files with less allocated bytes are written by one thread */
+        std::uintmax_t rangeThreshold;
+        /* optional journal of durable passes, owned by caller, erase resumes from it */
+        EraseJournal* journal;
+        /* optional timing of phases and passes, owned by caller and used by one thread */
+        EraseTelemetry* telemetry;
+
+        EraseOptions()
+            : backend(WriteBackend::STDIO_BACKEND)
+            , queueDepth(DEFAULT_QUEUE_DEPTH)
+            , mmapThreshold(DEFAULT_MMAP_THRESHOLD)
+            , patternPass(false)
+            , verify(false)
+            , progress(nullptr)
+            , bufferSize(0)
+            , chunkTuner(nullptr)
+            , syncPolicy(SyncPolicy::FILE_SYNC)
+            , syncBatchSize(DEFAULT_SYNC_BATCH_SIZE)
+            , rangeThreads(1)
+            , rangeThreshold(DEFAULT_RANGE_THRESHOLD)
+            , journal(nullptr)
+            , telemetry(nullptr) {
+        }
+        ~EraseOptions() = default;
+    };
+}
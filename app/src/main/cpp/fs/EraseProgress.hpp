@@ -0,0 +1,61 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace kl::fs {
+
+    /*
+     * Counters of running erase, updated by eraser threads with relaxed atomics
+     * and polled from Java. Cancel flag is checked between written chunks.
+     * Java object holds first reference and each running erase holds one more,
+     * so close() during an erase doesn't free counters under eraser threads.
+     */
+    struct EraseProgress final {
+        std::atomic<std::uint64_t> countBytes;
+        std::atomic<std::uint64_t> countFiles;
+        std::atomic<std::int32_t> pass;
+        std::atomic<bool> cancelled;
+        std::atomic<std::uint32_t> references;
+
+        EraseProgress() : countBytes(0), countFiles(0), pass(0), cancelled(false), references(1) {}
+        ~EraseProgress() = default;
+
+        EraseProgress(const EraseProgress&) = delete;
+        EraseProgress& operator=(const EraseProgress&) = delete;
+
+        void addBytes(std::uint64_t bytes) { countBytes.fetch_add(bytes, std::memory_order_relaxed); }
+        void addFile() { countFiles.fetch_add(1, std::memory_order_relaxed); }
+        void setPass(std::int32_t value) { pass.store(value, std::memory_order_relaxed); }
+
+        void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+        bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+        void retain() { references.fetch_add(1, std::memory_order_relaxed); }
+        /* return true, when last reference is released and progress should be deleted */
+        bool release() { return references.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+    };
+}
@@ -0,0 +1,1110 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "EraseSession.hpp"
+
+#include <fcntl.h>
+#include <linux/falloc.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <cinttypes>
+
+#include "FileUnit.hpp"
+#include <logging/Logging.hpp>
+#include <util/strings/StringUtil.hpp>
+
+namespace kl::fs {
+    using fs::literals::operator""_kb;
+    using fs::literals::operator""_mb;
+    using fs::literals::operator""_gb;
+
+    using namespace kl::util::strings;
+
+    static constexpr const char* TAG = "EraseSession-JNI";
+    static constexpr std::uintmax_t PROBE_SIZE = 8_mb;
+    static constexpr std::uintmax_t SLICE_SIZE = 8_mb;
+    static constexpr int MAX_RENAME_ATTEMPTS = 16;
+    /* constant patterns kept by session, larger chunks are filled per pass */
+    static constexpr std::size_t PATTERN_CACHE_SIZE = 16_mb;
+
+    /* renameat2 isn't declared by older libc, call it directly when kernel has it */
+    static int renameNoReplace(int directoryFd, const char* oldName, const char* newName) {
+#if defined(__NR_renameat2)
+        constexpr unsigned int RENAME_FLAG_NOREPLACE = 1 << 0;
+
+        if (::syscall(__NR_renameat2, directoryFd, oldName, directoryFd, newName, RENAME_FLAG_NOREPLACE) == 0) {
+            return 0;
+        }
+
+        if (errno != ENOSYS && errno != EINVAL) {
+            return -1;
+        }
+#endif
+        if (::faccessat(directoryFd, newName, F_OK, AT_SYMLINK_NOFOLLOW) == 0) {
+            errno = EEXIST;
+            return -1;
+        }
+
+        return ::renameat(directoryFd, oldName, directoryFd, newName);
+    }
+
+    EraseSession::EraseSession(BufferPool& pool)
+        : pool(pool)
+        , pattern(nullptr)
+        , patternBytes(0)
+        , blockSize(0)
+        , device(0)
+        , allocatedSize(0)
+        , activeBackend(WriteBackend::STDIO_BACKEND)
+        , uringUnavailable(false)
+        , verifier(pool)
+        , journalPass(0)
+        , journalOffset(0)
+        , random(util::random::ChaCha20::fromEntropy()) {
+    }
+
+    EraseSession::~EraseSession() {
+        if (auto result = syncBatch(); result.hasError()) {
+            log::error(TAG, result.error().message);
+        }
+    }
+
+    Result<std::uintmax_t, FileError> EraseSession::erase(const std::filesystem::path& newPath, OverwriteMode newMode,
+                                                          const EraseOptions& newOptions) {
+        const auto beginTime = std::chrono::steady_clock::now();
+
+        if (auto result = init(newPath, newMode, newOptions); result.hasError()) {
+            closeFile();
+            return static_cast<FileError>(result.error());
+        }
+
+        return eraseFile(beginTime);
+    }
+
+    Result<std::uintmax_t, FileError> EraseSession::erase(int directoryFd, const std::string& newName,
+                                                          OverwriteMode newMode, const EraseOptions& newOptions) {
+        const auto beginTime = std::chrono::steady_clock::now();
+
+        if (auto result = init(directoryFd, newName, newMode, newOptions); result.hasError()) {
+            closeFile();
+            return static_cast<FileError>(result.error());
+        }
+
+        return eraseFile(beginTime);
+    }
+
+    Result<std::uintmax_t, FileError> EraseSession::eraseFile(std::chrono::steady_clock::time_point beginTime) {
+        if (auto result = prepareFile(); result.hasError()) {
+            closeFile();
+            return static_cast<FileError>(result.error());
+        }
+
+        if (auto result = overwriteFile(); result.hasError()) {
+            closeFile();
+            return static_cast<FileError>(result.error());
+        }
+
+        if (journal.has_value()) {
+            journal->remove();
+            journal.reset();
+        }
+
+        if (eraseEntry.options.syncPolicy == SyncPolicy::FILE_SYNC) {
+            if (auto result = syncFile(); result.hasError()) {
+                closeFile();
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        if (eraseEntry.options.syncPolicy == SyncPolicy::BATCH_SYNC) {
+            auto result = deferFile();
+            closeFile();
+
+            if (result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+
+            countFile(beginTime);
+
+            return eraseEntry.fileSize;
+        }
+
+        if (auto result = truncateFile(0); result.hasError()) {
+            closeFile();
+            return static_cast<FileError>(result.error());
+        }
+
+        closeFile();
+
+        if (auto result = removeFile(); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        countFile(beginTime);
+
+        return eraseEntry.fileSize;
+    }
+
+    void EraseSession::countFile(std::chrono::steady_clock::time_point beginTime) {
+        const auto& options = eraseEntry.options;
+
+        if (options.progress != nullptr) {
+            options.progress->addFile();
+        }
+
+        if (options.telemetry != nullptr) {
+            const auto duration = std::chrono::steady_clock::now() - beginTime;
+
+            options.telemetry->totalNanos += static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+            options.telemetry->countFiles++;
+        }
+    }
+
+    Result<void, FileError> EraseSession::init(const std::filesystem::path& newPath, OverwriteMode newMode,
+                                               const EraseOptions& newOptions) {
+        PhaseTimer timer(newOptions.telemetry, ErasePhase::OPEN_PHASE);
+        const std::filesystem::path parentPath = newPath.has_parent_path() ? newPath.parent_path() : ".";
+        UniqueFd parent(::open(parentPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+
+        if (!parent) {
+            return FileError("Can't open directory %s, error %s", parentPath.c_str(), ::strerror(errno));
+        }
+
+        return initEntry(std::move(parent), newPath.filename(), newPath, newMode, newOptions);
+    }
+
+    Result<void, FileError> EraseSession::init(int directoryFd, const std::string& newName, OverwriteMode newMode,
+                                               const EraseOptions& newOptions) {
+        PhaseTimer timer(newOptions.telemetry, ErasePhase::OPEN_PHASE);
+
+        /* session closes its directory after remove, so keep own copy of caller's descriptor */
+        UniqueFd parent(::fcntl(directoryFd, F_DUPFD_CLOEXEC, 0));
+
+        if (!parent) {
+            return FileError("Can't duplicate directory descriptor, error %s", ::strerror(errno));
+        }
+
+        return initEntry(std::move(parent), newName, newName, newMode, newOptions);
+    }
+
+    /*
+     * Open parent directory and the file itself once, all next steps work with
+     * these descriptors, so the path isn't resolved again and can't be swapped.
+     */
+    Result<void, FileError> EraseSession::initEntry(UniqueFd&& parent, const std::string& newName,
+                                                    const std::string& fileName, OverwriteMode newMode,
+                                                    const EraseOptions& newOptions) {
+        this->directory = std::move(parent);
+        this->name = newName;
+
+        eraseEntry.fileName = fileName;
+        eraseEntry.mode = newMode;
+        eraseEntry.options = newOptions;
+
+        if (newOptions.progress != nullptr && newOptions.progress->isCancelled()) {
+            return FileError("Erase of %s is cancelled", fileName.c_str());
+        }
+
+        if (auto result = openPath(); result.hasError()) {
+            log::error(TAG, result.error().message);
+            return static_cast<FileError>(result.error());
+        }
+
+        struct stat fileInfo = {};
+
+        if (::fstat(::fileno(file.get()), &fileInfo) == -1) {
+            return FileError("Can't get file %s status, error %s", eraseEntry.fileName.c_str(), ::strerror(errno));
+        }
+
+        std::string errorMessage;
+
+        if (!S_ISREG(fileInfo.st_mode)) {
+            errorMessage = "File isn't regular file";
+            log::error(TAG, errorMessage);
+            return FileError(errorMessage);
+        }
+
+        if (fileInfo.st_nlink != 1) {
+            errorMessage = "Count hard link must only be one";
+            log::error(TAG, errorMessage);
+            return FileError(errorMessage);
+        }
+
+        showPermission(fileInfo.st_mode);
+
+        const std::uint32_t fileBlockSize = fileInfo.st_blksize > 16 ? static_cast<std::uint32_t>(fileInfo.st_blksize) : 512;
+        const auto fileSize = static_cast<std::uintmax_t>(fileInfo.st_size);
+
+        if (newOptions.bufferSize != 0) {
+            eraseEntry.bufferSize = newOptions.bufferSize;
+        } else if (newOptions.chunkTuner != nullptr && fileSize > ChunkTuner::CANDIDATE_SIZES.front()) {
+            const std::uint32_t chunkSize = newOptions.chunkTuner->chunkSize(pool, directory.get(), fileInfo.st_dev);
+            /* chunk isn't larger than file rounded up to block, buffer is refilled every pass */
+            const std::uintmax_t roundedSize = (fileSize + fileBlockSize - 1) / fileBlockSize * fileBlockSize;
+
+            if (chunkSize != 0) {
+                eraseEntry.bufferSize = static_cast<std::uint32_t>(std::min<std::uintmax_t>(chunkSize, roundedSize));
+            } else {
+                eraseEntry.bufferSize = fileBlockSize;
+            }
+        } else {
+            eraseEntry.bufferSize = fileBlockSize;
+        }
+
+        eraseEntry.fileSize = fileSize;
+        blockSize = static_cast<std::size_t>(fileInfo.st_blksize);
+        device = fileInfo.st_dev;
+
+        if (newOptions.journal != nullptr) {
+            if (auto result = newOptions.journal->open(::fileno(file.get()), fileInfo, newMode); result.hasValue()) {
+                this->journal = std::move(result.value());
+            } else {
+                log::info(TAG, "Erase %s without journal: %s", fileName.c_str(), result.error().message.get().c_str());
+            }
+        }
+
+        return {};
+    }
+
+    Result<void, FileError> EraseSession::openPath() {
+        /* O_NONBLOCK keeps open of fifo from hanging, it doesn't change I/O of regular file */
+        constexpr int flags = O_RDWR | O_NOFOLLOW | O_NONBLOCK | O_CLOEXEC;
+        int fd = ::openat(directory.get(), name.c_str(), flags);
+
+        if (fd == -1 && errno == EACCES) {
+            struct stat linkInfo = {};
+
+            /* owner has no read/write permission, add it and try again */
+            if (::fstatat(directory.get(), name.c_str(), &linkInfo, AT_SYMLINK_NOFOLLOW) == 0 &&
+                S_ISREG(linkInfo.st_mode) &&
+                ::fchmodat(directory.get(), name.c_str(), (linkInfo.st_mode & 07777) | S_IRUSR | S_IWUSR, 0) == 0) {
+                fd = ::openat(directory.get(), name.c_str(), flags);
+            } else {
+                errno = EACCES;
+            }
+        }
+
+        if (fd == -1) {
+            switch (errno) {
+            case ENOENT:
+                return FileError("File doesn't exist");
+            case ELOOP:
+                return FileError("File %s is symlink", eraseEntry.fileName.c_str());
+            default:
+                return FileError("Can't open file %s, error %s", eraseEntry.fileName.c_str(), ::strerror(errno));
+            }
+        }
+
+        FILE* handle = ::fdopen(fd, "r+b");
+
+        if (handle == nullptr) {
+            ::close(fd);
+            return FileError("Can't open stream of file %s, error %s", eraseEntry.fileName.c_str(), ::strerror(errno));
+        }
+
+        this->file = FileUniquePtr(handle);
+
+        return {};
+    }
+
+    void EraseSession::showPermission(mode_t permission) {
+        log::debug(TAG, "owner permission: %s-%s-%s",
+              ((permission & S_IRUSR) != 0 ? "r" : "-"),
+              ((permission & S_IWUSR) != 0 ? "w" : "-"),
+              ((permission & S_IXUSR) != 0 ? "x" : "-"));
+
+        log::debug(TAG, "group permission: %s-%s-%s",
+              ((permission & S_IRGRP) != 0 ? "r" : "-"),
+              ((permission & S_IWGRP) != 0 ? "w" : "-"),
+              ((permission & S_IXGRP) != 0 ? "x" : "-"));
+
+        log::debug(TAG, "other permission: %s-%s-%s",
+              ((permission & S_IROTH) != 0 ? "r" : "-"),
+              ((permission & S_IWOTH) != 0 ? "w" : "-"),
+              ((permission & S_IXOTH) != 0 ? "x" : "-"));
+    }
+
+    /*
+     * Rename file to random name of the same length and unlink it, both relative
+     * to parent directory. New name never replaces an existing entry.
+     */
+    static Result<void, FileError> removeEntry(int directoryFd, const std::string& name, const std::string& fileName,
+                                               EraseTelemetry* telemetry) {
+        std::string randomName;
+        int status = -1;
+
+        for (int attempt = 0; attempt < MAX_RENAME_ATTEMPTS && status == -1; ++attempt) {
+            PhaseTimer timer(telemetry, ErasePhase::RENAME_PHASE);
+            randomName = randomBuffer(name.size());
+            status = renameNoReplace(directoryFd, name.c_str(), randomName.c_str());
+
+            if (status == -1 && errno != EEXIST) {
+                return FileError("Can't rename file %s, error %s", fileName.c_str(), ::strerror(errno));
+            }
+        }
+
+        if (status == -1) {
+            /* content is already wiped, so only name stays visible in directory */
+            log::info(TAG, "Can't find free name for file %s, remove without rename", fileName.c_str());
+            randomName = name;
+        }
+
+        PhaseTimer timer(telemetry, ErasePhase::UNLINK_PHASE);
+
+        if (::unlinkat(directoryFd, randomName.c_str(), 0) == -1) {
+            return FileError("Can't remove file %s, error %s", fileName.c_str(), ::strerror(errno));
+        }
+
+        log::debug(TAG, "Remove file: %s", fileName.c_str());
+
+        return {};
+    }
+
+    Result<void, FileError> EraseSession::removeFile() {
+        auto result = removeEntry(directory.get(), name, eraseEntry.fileName, eraseEntry.options.telemetry);
+        directory.reset();
+
+        return result;
+    }
+
+    Result<void, FileError> EraseSession::syncFile() {
+        if (!file) {
+            return FileError("File isn't opened");
+        }
+
+        PhaseTimer timer(eraseEntry.options.telemetry, ErasePhase::SYNC_PHASE);
+
+        if (::fdatasync(::fileno(file.get())) == -1) {
+            return FileError("Can't sync file %s, error %s", eraseEntry.fileName.c_str(), ::strerror(errno));
+        }
+
+        return {};
+    }
+
+    /*
+     * Keep overwritten file open until its batch is synced, truncate would drop
+     * its dirty pages before they are written back.
+     */
+    Result<void, FileError> EraseSession::deferFile() {
+        pendingFiles.push_back({std::move(directory), std::move(file), device, name, eraseEntry.fileName});
+
+        if (pendingFiles.size() >= std::max<std::uint32_t>(eraseEntry.options.syncBatchSize, 1)) {
+            return syncBatch();
+        }
+
+        return {};
+    }
+
+    Result<void, FileError> EraseSession::syncBatch() {
+        std::vector<PendingFile> batch = std::move(pendingFiles);
+        std::vector<dev_t> syncedDevices;
+        EraseTelemetry* telemetry = eraseEntry.options.telemetry;
+        pendingFiles.clear();
+
+        for (const auto& pending : batch) {
+            PhaseTimer timer(telemetry, ErasePhase::SYNC_PHASE);
+            const int fd = ::fileno(pending.file.get());
+
+            if (std::find(syncedDevices.begin(), syncedDevices.end(), pending.device) != syncedDevices.end()) {
+                continue;
+            }
+
+            if (::syscall(__NR_syncfs, fd) == 0) {
+                syncedDevices.push_back(pending.device);
+            } else if (errno != ENOSYS || ::fdatasync(fd) == -1) {
+                return FileError("Can't sync file %s, error %s", pending.fileName.c_str(), ::strerror(errno));
+            }
+        }
+
+        for (const auto& pending : batch) {
+            {
+                PhaseTimer timer(telemetry, ErasePhase::TRUNCATE_PHASE);
+
+                if (::ftruncate(::fileno(pending.file.get()), 0) == -1) {
+                    return FileError("Can't truncate file %s, error %s", pending.fileName.c_str(), ::strerror(errno));
+                }
+            }
+
+            if (auto result = removeEntry(pending.directory.get(), pending.name, pending.fileName, telemetry);
+                result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        log::debug(TAG, "Sync batch of %zu files", batch.size());
+
+        return {};
+    }
+
+    Result<void, FileError> EraseSession::truncateFile(std::size_t size) {
+        if (!file) {
+            return FileError("File isn't opened");
+        }
+
+        PhaseTimer timer(eraseEntry.options.telemetry, ErasePhase::TRUNCATE_PHASE);
+
+        if (::ftruncate(::fileno(file.get()), static_cast<off_t>(size)) == -1) {
+            return FileError("Can't truncate file %s, error %s", eraseEntry.fileName.c_str(), ::strerror(errno));
+        }
+
+        log::debug(TAG, "Truncate file: %s", eraseEntry.fileName.c_str());
+
+        return {};
+    }
+
+    Result<void, FileError> EraseSession::prepareFile() {
+        PhaseTimer timer(eraseEntry.options.telemetry, ErasePhase::PREPARE_PHASE);
+        std::size_t alignment = BufferPool::DEFAULT_ALIGNMENT;
+        activeBackend = WriteBackend::STDIO_BACKEND;
+
+        if (eraseEntry.options.backend == WriteBackend::DIRECT_BACKEND) {
+            if (auto result = DirectWriter::open(::fileno(file.get()), blockSize); result.hasValue()) {
+                this->direct = std::move(result.value());
+                alignment = direct->alignment();
+                eraseEntry.bufferSize = (eraseEntry.bufferSize + alignment - 1) / alignment * alignment;
+                activeBackend = WriteBackend::DIRECT_BACKEND;
+            } else {
+                log::info(TAG, "Fall back to stdio backend: %s", result.error().message.get().c_str());
+            }
+        }
+
+        const auto schedule = eraseEntry.mode == OverwriteMode::DISCARD_MODE ? std::span<const OverwritePass>(SIMPLE_SCHEDULE)
+                                                                               : passSchedule(eraseEntry.mode);
+
+        if (const std::size_t period = patternPeriod(schedule); period > 1) {
+            const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            eraseEntry.bufferSize = static_cast<std::uint32_t>(
+                    alignChunkSize(eraseEntry.bufferSize, period, std::max(alignment, pageSize)));
+        }
+
+        if (!buffer || buffer.size() < eraseEntry.bufferSize || buffer.alignment() < alignment) {
+            this->buffer = pool.acquire(eraseEntry.bufferSize, alignment);
+        }
+
+        if (eraseEntry.options.backend == WriteBackend::URING_BACKEND && !uringUnavailable) {
+            if (auto result = prepareUring(); result.hasError()) {
+                log::info(TAG, "Fall back to stdio backend: %s", result.error().message.get().c_str());
+            }
+        }
+
+        if (eraseEntry.options.backend == WriteBackend::MMAP_BACKEND) {
+            mapped.emplace(::fileno(file.get()), eraseEntry.bufferSize,
+                           eraseEntry.options.syncPolicy == SyncPolicy::PASS_SYNC);
+            activeBackend = WriteBackend::MMAP_BACKEND;
+        }
+
+        prepareExtents();
+
+        /*
+         * Probe writes leading ranges of file, so it runs only for file without holes.
+         * Failed write of mapped page kills the process with SIGBUS, so AUTO never maps
+         * file of filesystem, which needs free space even for overwrite.
+         */
+        if (eraseEntry.options.backend == WriteBackend::AUTO_BACKEND && allocatedSize == eraseEntry.fileSize &&
+            eraseEntry.fileSize >= std::max(eraseEntry.options.mmapThreshold, 2 * PROBE_SIZE) &&
+            overwritesInPlace(::fileno(file.get()))) {
+            mapped.emplace(::fileno(file.get()), eraseEntry.bufferSize,
+                           eraseEntry.options.syncPolicy == SyncPolicy::PASS_SYNC);
+            activeBackend = WriteBackend::AUTO_BACKEND;
+        }
+
+        if (activeBackend == WriteBackend::STDIO_BACKEND && eraseEntry.options.rangeThreads > 1 &&
+            allocatedSize >= eraseEntry.options.rangeThreshold) {
+            const std::uintmax_t countRanges = (allocatedSize + RangeWriter::RANGE_SIZE - 1) / RangeWriter::RANGE_SIZE;
+            ranges.emplace(::fileno(file.get()),
+                           static_cast<std::size_t>(std::min<std::uintmax_t>(eraseEntry.options.rangeThreads, countRanges)));
+        }
+
+        return {};
+    }
+
+    void EraseSession::prepareExtents() {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+
+        /* page alignment suits mapped windows, direct writes need their own alignment */
+        std::size_t alignment = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+        if (activeBackend == WriteBackend::DIRECT_BACKEND) {
+            alignment = std::max(alignment, direct->alignment());
+        }
+
+        if (auto result = findExtents(::fileno(file.get()), fileSize, alignment); result.hasValue()) {
+            this->extents = std::move(result.value());
+        } else {
+            log::info(TAG, "Fall back to whole file: %s", result.error().message.get().c_str());
+            this->extents = {{0, fileSize}};
+        }
+
+        allocatedSize = 0;
+
+        for (const auto& extent : extents) {
+            allocatedSize += extent.length;
+        }
+
+        if (allocatedSize != fileSize) {
+            log::debug(TAG, "File %s has %zu extents with %ju of %ju bytes", fileName.c_str(),
+                       extents.size(), allocatedSize, fileSize);
+        }
+    }
+
+    Result<void, FileError> EraseSession::prepareUring() {
+        if (!uring) {
+            if (auto result = UringWriter::create(eraseEntry.options.queueDepth); result.hasValue()) {
+                this->uring = std::move(result.value());
+            } else {
+                uringUnavailable = true;
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        if (auto result = uring->registerFile(::fileno(file.get())); result.hasError()) {
+            uringUnavailable = true;
+            return static_cast<FileError>(result.error());
+        }
+
+        if (auto result = uring->registerBuffer(buffer.get(), eraseEntry.bufferSize); result.hasError()) {
+            uring->unregister();
+            uringUnavailable = true;
+            return static_cast<FileError>(result.error());
+        }
+
+        activeBackend = WriteBackend::URING_BACKEND;
+
+        return {};
+    }
+
+    /*
+     * Write first probe range with pwrite and second one through mapping,
+     * finish the pass and all next passes with the faster of them.
+     */
+    Result<std::uintmax_t, FileError> EraseSession::probeBackend() {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+        const int fd = ::fileno(file.get());
+
+        const std::size_t granularity = mapped->granularity();
+        const std::uintmax_t probeSize = std::max<std::uintmax_t>(PROBE_SIZE / granularity, 1) * granularity;
+        std::uintmax_t written = 0;
+
+        auto beginTime = std::chrono::steady_clock::now();
+
+        if (auto result = writePattern(fd, pattern, bufferSize, 0, probeSize); result.hasValue()) {
+            written += result.value();
+        } else {
+            return static_cast<FileError>(result.error());
+        }
+
+        /* both paths are measured with writeback, otherwise page cache hides the difference */
+        ::fdatasync(fd);
+
+        if (auto result = completeChunk(0, probeSize); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        auto writeTime = std::chrono::steady_clock::now() - beginTime;
+        beginTime = std::chrono::steady_clock::now();
+
+        if (auto result = mapped->writeRange(pattern, probeSize, probeSize); result.hasValue()) {
+            written += result.value();
+        } else {
+            return static_cast<FileError>(result.error());
+        }
+
+        ::fdatasync(fd);
+
+        auto mapTime = std::chrono::steady_clock::now() - beginTime;
+
+        if (auto result = completeChunk(probeSize, probeSize); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        activeBackend = mapTime < writeTime ? WriteBackend::MMAP_BACKEND : WriteBackend::STDIO_BACKEND;
+
+        log::debug(TAG, "Choose %s for %s: write %lld us, mmap %lld us", WRITE_BACKEND.name(activeBackend),
+                   fileName.c_str(),
+                   static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(writeTime).count()),
+                   static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(mapTime).count()));
+
+        const std::uintmax_t offset = 2 * probeSize;
+
+        if (auto result = overwriteExtent({offset, fileSize - offset}); result.hasValue()) {
+            return written + result.value();
+        } else {
+            return static_cast<FileError>(result.error());
+        }
+    }
+
+    void EraseSession::closeFile() {
+        PhaseTimer timer(file ? eraseEntry.options.telemetry : nullptr, ErasePhase::CLOSE_PHASE);
+
+        /* failed or cancelled pass leaves verifier reading fd and pattern, which are released below */
+        verifier.cancel();
+
+        if (activeBackend == WriteBackend::URING_BACKEND) {
+            uring->unregister();
+        }
+
+        activeBackend = WriteBackend::STDIO_BACKEND;
+        direct.reset();
+        mapped.reset();
+        ranges.reset();
+        journal.reset();
+        extents.clear();
+        allocatedSize = 0;
+        file.reset();
+        buffer.reset();
+        bufferPattern.reset();
+        pattern = nullptr;
+    }
+
+    Result<void, FileError> EraseSession::overwriteFile() {
+        if (eraseEntry.mode != OverwriteMode::DISCARD_MODE) {
+            return runSchedule(passSchedule(eraseEntry.mode));
+        }
+
+        if (eraseEntry.options.patternPass) {
+            if (auto result = runSchedule(SIMPLE_SCHEDULE); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        return discardFile();
+    }
+
+    Result<void, FileError> EraseSession::runSchedule(std::span<const OverwritePass> schedule) {
+        for (std::size_t i = 0; i < schedule.size(); ++i) {
+            const int pass = static_cast<int>(i) + 1;
+
+            if (journal.has_value() && static_cast<std::uint32_t>(pass) < journal->pass()) {
+                log::debug(TAG, "Skip pass %d of %s, it's committed in journal", pass, eraseEntry.fileName.c_str());
+                continue;
+            }
+
+            preparePattern(schedule[i]);
+
+            if (auto result = overwriteBuffer(pass); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        return {};
+    }
+
+    /*
+     * Random pass refills buffer of the file every time. Constant patterns are
+     * built once per session, so repeated passes and next files reuse them while
+     * they fit the cache. io_uring writes only from its registered buffer, so its
+     * pattern is filled there, and refill is skipped for the same pattern.
+     */
+    void EraseSession::preparePattern(const OverwritePass& pass) {
+        const std::size_t bufferSize = eraseEntry.bufferSize;
+
+        if (pass.kind == PassKind::RANDOM_PASS) {
+            random.fill(buffer.get(), bufferSize);
+            bufferPattern.reset();
+            this->pattern = buffer.get();
+            return;
+        }
+
+        if (activeBackend != WriteBackend::URING_BACKEND) {
+            auto cached = std::find_if(patterns.begin(), patterns.end(), [&pass](const PatternBuffer& patternBuffer) {
+                return patternBuffer.pass == pass;
+            });
+
+            if (cached != patterns.end() && cached->size >= bufferSize &&
+                cached->buffer.alignment() >= buffer.alignment()) {
+                this->pattern = cached->buffer.get();
+                return;
+            }
+
+            if (cached != patterns.end()) {
+                patternBytes -= cached->size;
+                patterns.erase(cached);
+            }
+
+            if (patternBytes + bufferSize <= PATTERN_CACHE_SIZE) {
+                PooledBuffer patternBuffer = pool.acquire(bufferSize, buffer.alignment());
+                fillPattern(patternBuffer.get(), bufferSize, pass);
+
+                this->pattern = patternBuffer.get();
+                patternBytes += bufferSize;
+                patterns.push_back({pass, std::move(patternBuffer), bufferSize});
+                return;
+            }
+        }
+
+        if (bufferPattern != pass) {
+            fillPattern(buffer.get(), bufferSize, pass);
+            bufferPattern = pass;
+        }
+
+        this->pattern = buffer.get();
+    }
+
+    /*
+     * Deallocate extents, filesystem mounted with discard (or f2fs) trims freed
+     * blocks of flash once punching is committed by sync.
+     */
+    Result<void, FileError> EraseSession::discardFile() {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+        const int fd = ::fileno(file.get());
+        std::optional<PhaseTimer> timer(std::in_place, options.telemetry, ErasePhase::DISCARD_PHASE);
+
+        for (const auto& [offset, length] : extents) {
+            if (::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                            static_cast<off_t>(offset), static_cast<off_t>(length)) == 0) {
+                continue;
+            }
+
+            if ((errno == EOPNOTSUPP || errno == ENOSYS) && !options.patternPass) {
+                log::info(TAG, "Punch hole isn't supported for %s, fall back to zero pass", fileName.c_str());
+                timer.reset();
+
+                return runSchedule(SIMPLE_SCHEDULE);
+            }
+
+            return FileError("Can't punch hole in file, error %s", ::strerror(errno));
+        }
+
+        timer.reset();
+
+        if (options.syncPolicy == SyncPolicy::PASS_SYNC) {
+            if (auto result = syncFile(); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        log::debug(TAG, "Discard %ju bytes of %s", allocatedSize, fileName.c_str());
+
+        return {};
+    }
+
+    Result<std::uintmax_t, FileError> EraseSession::overwriteBuffer(int pass) {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+
+        std::uintmax_t written = 0;
+        std::uintmax_t beginOffset = 0;
+        std::string errorMessage;
+
+        if (journal.has_value()) {
+            if (static_cast<std::uint32_t>(pass) == journal->pass()) {
+                /* backend of resumed run may need stricter alignment than previous one */
+                const std::size_t alignment = std::max<std::size_t>(::sysconf(_SC_PAGESIZE),
+                                                                    direct ? direct->alignment() : 1);
+                beginOffset = journal->offset() / alignment * alignment;
+            }
+
+            journalPass = static_cast<std::uint32_t>(pass);
+            journalOffset = beginOffset;
+        }
+
+        std::vector<FileExtent> passExtents;
+        std::uintmax_t passSize = 0;
+
+        for (const auto& [offset, length] : extents) {
+            if (offset + length <= beginOffset) {
+                continue;
+            }
+
+            const std::uintmax_t begin = std::max(offset, beginOffset);
+            passExtents.push_back({begin, offset + length - begin});
+            passSize += offset + length - begin;
+        }
+#if 0
+        log::debug(TAG, "Overwrite [buffer size=%d, file size=%" PRId64 ", extents=%zu, pass=%d]",
+                   bufferSize, fileSize, extents.size(), pass);
+#endif
+        auto beginTime = std::chrono::steady_clock::now();
+        EraseTelemetry* telemetry = options.telemetry;
+        const auto syncIndex = static_cast<std::size_t>(ErasePhase::SYNC_PHASE);
+        const TelemetrySample beginSample = telemetry != nullptr ? TelemetrySample::now() : TelemetrySample{};
+        const std::uint64_t syncNanos = telemetry != nullptr ? telemetry->phaseNanos[syncIndex] : 0;
+        const std::uint64_t syncIoCalls = telemetry != nullptr ? telemetry->phaseIoCalls[syncIndex] : 0;
+
+        if (options.verify) {
+            verifier.start(::fileno(file.get()), pattern, bufferSize);
+        }
+
+        if (options.progress != nullptr) {
+            options.progress->setPass(pass);
+        }
+
+        if (activeBackend == WriteBackend::AUTO_BACKEND && beginOffset == 0) {
+            if (auto result = probeBackend(); result.hasValue()) {
+                written = result.value();
+            } else {
+                log::error(TAG, result.error().message);
+                return static_cast<FileError>(result.error());
+            }
+        } else if (ranges.has_value()) {
+            if (auto result = overwriteRanges(passExtents); result.hasValue()) {
+                written = result.value();
+            } else {
+                log::error(TAG, result.error().message);
+                return static_cast<FileError>(result.error());
+            }
+        } else {
+            for (const auto& extent : passExtents) {
+                if (auto result = overwriteExtent(extent); result.hasValue()) {
+                    written += result.value();
+                } else {
+                    log::error(TAG, result.error().message);
+                    return static_cast<FileError>(result.error());
+                }
+            }
+        }
+
+        if (written != passSize) {
+            errorMessage = "Fail overwrite all file";
+            log::error(TAG, errorMessage);
+            return FileError(errorMessage);
+        }
+
+        if (activeBackend == WriteBackend::STDIO_BACKEND) {
+            ::fflush(file.get());
+        }
+
+        if (options.syncPolicy == SyncPolicy::PASS_SYNC) {
+            if (auto result = syncFile(); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        if (options.verify) {
+            if (auto result = finishVerify(pass); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        if (journal.has_value()) {
+            if (auto result = commitJournal(static_cast<std::uint32_t>(pass) + 1, 0); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        auto endTime = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(endTime - beginTime).count();
+
+        /* syncs of PASS_SYNC and journal are counted by SYNC_PHASE */
+        if (telemetry != nullptr) {
+            telemetry->addPass(pass, beginSample, TelemetrySample::now(), written,
+                               telemetry->phaseNanos[syncIndex] - syncNanos,
+                               telemetry->phaseIoCalls[syncIndex] - syncIoCalls);
+        }
+
+        log::debug(TAG, "Pass %d of %s with %s: %.2f MB/s", pass, OVERWRITE_MODE.name(mode),
+                   WRITE_BACKEND.name(activeBackend),
+                   seconds > 0.0 ? static_cast<double>(written) / 1_mb / seconds : 0.0);
+
+        return written;
+    }
+
+    /*
+     * Backends other than stdio write extent by slices, so progress, cancel flag
+     * and verification are handled between slices as well as between chunks.
+     */
+    Result<std::uintmax_t, FileError> EraseSession::overwriteExtent(const FileExtent& extent) {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+        const auto& [offset, length] = extent;
+
+        if (activeBackend == WriteBackend::STDIO_BACKEND) {
+            if (::fseeko(file.get(), static_cast<off_t>(offset), SEEK_SET) != 0) {
+                return FileError("Fail seek in file");
+            }
+
+            return writeBuffer(offset, length / bufferSize, static_cast<std::size_t>(length % bufferSize));
+        }
+
+        const std::size_t granularity = std::lcm<std::size_t>(bufferSize, ::sysconf(_SC_PAGESIZE));
+        const std::uintmax_t sliceSize = (SLICE_SIZE + granularity - 1) / granularity * granularity;
+        std::uintmax_t written = 0;
+
+        while (written < length) {
+            const std::uintmax_t sliceOffset = offset + written;
+            const std::uintmax_t size = std::min(sliceSize, length - written);
+            Result<std::uintmax_t, FileError> result = std::uintmax_t(0);
+
+            switch (activeBackend) {
+            case WriteBackend::URING_BACKEND:
+                result = uring->writeRange(sliceOffset, size, bufferSize);
+                break;
+            case WriteBackend::DIRECT_BACKEND:
+                result = direct->writeRange(pattern, bufferSize, sliceOffset, size);
+                break;
+            default:
+                result = mapped->writeRange(pattern, sliceOffset, size);
+                break;
+            }
+
+            if (result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+
+            if (auto completed = completeChunk(sliceOffset, size); completed.hasError()) {
+                return static_cast<FileError>(completed.error());
+            }
+
+            written += result.value();
+        }
+
+        return written;
+    }
+
+    /*
+     * Stdio stream is flushed after each pass, so writer threads use its descriptor
+     * directly. Progress and verifier are shared by threads, cancel flag stops all.
+     */
+    Result<std::uintmax_t, FileError> EraseSession::overwriteRanges(const std::vector<FileExtent>& passExtents) {
+        return ranges->writeExtents(pattern, eraseEntry.bufferSize, passExtents,
+                                    [this](std::uintmax_t offset, std::uintmax_t length) {
+            return completeChunk(offset, length);
+        });
+    }
+
+    Result<void, FileError> EraseSession::completeChunk(std::uintmax_t offset, std::uintmax_t length) {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+
+        if (options.verify) {
+            verifier.submit(offset, length);
+        }
+
+        if (options.progress != nullptr) {
+            options.progress->addBytes(length);
+
+            if (options.progress->isCancelled()) {
+                log::info(TAG, "Erase of %s is cancelled at %ju", fileName.c_str(), offset + length);
+                return FileError("Erase of %s is cancelled", fileName.c_str());
+            }
+        }
+
+        /* ranges complete out of order, so their pass is committed only at its end */
+        if (journal.has_value() && !ranges.has_value() &&
+            offset + length >= journalOffset + EraseJournal::COMMIT_INTERVAL) {
+            return commitJournal(journalPass, offset + length);
+        }
+
+        return {};
+    }
+
+    /*
+     * Data of the file is synced before journal record, so the record never
+     * gets ahead of the device. Failed journal write only disables resume.
+     */
+    Result<void, FileError> EraseSession::commitJournal(std::uint32_t pass, std::uintmax_t offset) {
+        if (activeBackend == WriteBackend::STDIO_BACKEND) {
+            ::fflush(file.get());
+        }
+
+        if (auto result = syncFile(); result.hasError()) {
+            return static_cast<FileError>(result.error());
+        }
+
+        if (auto result = journal->commit(pass, offset); result.hasError()) {
+            log::error(TAG, result.error().message);
+            journal.reset();
+            return {};
+        }
+
+        journalOffset = offset;
+
+        return {};
+    }
+
+    Result<void, FileError> EraseSession::finishVerify(int pass) {
+        if (auto result = verifier.finish(); result.hasError()) {
+            log::error(TAG, result.error().message);
+            return static_cast<FileError>(result.error());
+        }
+
+        if (verifier.countMismatches() == 0) {
+            return {};
+        }
+
+        std::string offsets;
+
+        for (std::uintmax_t offset : verifier.mismatches()) {
+            offsets += (offsets.empty() ? "" : ", ") + std::to_string(offset);
+        }
+
+        FileError error("Verify pass %d of %s failed in %ju chunks at offsets %s", pass,
+                        eraseEntry.fileName.c_str(), verifier.countMismatches(), offsets.c_str());
+        log::error(TAG, error.message);
+
+        return error;
+    }
+
+    Result<std::uintmax_t, FileError> EraseSession::writeBuffer(std::uintmax_t offset, std::uintmax_t count, std::size_t tail) {
+        const auto& [fileName, fileSize, bufferSize, mode, options] = eraseEntry;
+        std::uintmax_t written = 0;
+        std::string errorMessage;
+
+        if (count != 0) {
+            for (std::uintmax_t i = 0; i < count; ++i) {
+                if (auto tmp = std::fwrite(pattern, 1, bufferSize, file.get()); tmp == bufferSize) {
+                    if (options.verify) {
+                        ::fflush(file.get());
+                    }
+
+                    if (auto result = completeChunk(offset + written, tmp); result.hasError()) {
+                        return static_cast<FileError>(result.error());
+                    }
+
+                    written += tmp;
+                } else {
+                    errorMessage = "Fail write buffer to file";
+                    log::error(TAG, errorMessage);
+                    return FileError(errorMessage);
+                }
+            }
+        }
+
+        if (auto tmp = std::fwrite(pattern, 1, tail, file.get()); tmp == tail) {
+            if (options.verify && tmp != 0) {
+                ::fflush(file.get());
+            }
+
+            if (auto result = completeChunk(offset + written, tmp); result.hasError()) {
+                return static_cast<FileError>(result.error());
+            }
+
+            written += tmp;
+        } else {
+            errorMessage = "Fail write tail buffer to file";
+            log::error(TAG, errorMessage);
+            return FileError(errorMessage);
+        }
+
+        log::debug(TAG, "File written %ju with size %ju", written, fileSize);
+
+        return written;
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BufferPool.hpp"
+#include "EraseEntry.hpp"
+#include "EraseJournal.hpp"
+#include "EraseTelemetry.hpp"
+#include "EraseOptions.hpp"
+#include "OverwriteMode.hpp"
+#include "PassSchedule.hpp"
+#include "FileUtil.hpp"
+#include "FileError.hpp"
+#include "UringWriter.hpp"
+#include "DirectWriter.hpp"
+#include "MappedWriter.hpp"
+#include "PassVerifier.hpp"
+#include "RangeWriter.hpp"
+#include "WriteBackend.hpp"
+
+#include <util/error/Result.hpp>
+#include <util/random/ChaCha20.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+
+    /* overwritten file, which waits for sync of its batch */
+    struct PendingFile final {
+        UniqueFd directory;
+        FileUniquePtr file;
+        dev_t device;
+        std::string name;
+        std::string fileName;
+    };
+
+    /* constant pattern filled once and reused by next passes and files */
+    struct PatternBuffer final {
+        OverwritePass pass;
+        PooledBuffer buffer;
+        std::size_t size;
+    };
+
+    /*
+     * State of erasing one file at a time. A session isn't shared between threads,
+     * but could be reused for many files, e.g. one session per worker thread.
+     */
+    class EraseSession final {
+    public:
+        explicit EraseSession(BufferPool& pool);
+        ~EraseSession();
+
+        EraseSession(const EraseSession&) = delete;
+        EraseSession& operator=(const EraseSession&) = delete;
+
+        /* run whole erase sequence, return count of erased bytes */
+        Result<std::uintmax_t, FileError> erase(const std::filesystem::path& path, OverwriteMode newMode,
+                                                const EraseOptions& newOptions = EraseOptions());
+
+        /* same as above for file name relative to directory, descriptor stays owned by caller */
+        Result<std::uintmax_t, FileError> erase(int directoryFd, const std::string& name, OverwriteMode newMode,
+                                                const EraseOptions& newOptions = EraseOptions());
+
+        Result<void, FileError> init(const std::filesystem::path& path, OverwriteMode newMode,
+                                     const EraseOptions& newOptions = EraseOptions());
+        Result<void, FileError> init(int directoryFd, const std::string& name, OverwriteMode newMode,
+                                     const EraseOptions& newOptions = EraseOptions());
+
+        Result<void, FileError> prepareFile();
+        Result<void, FileError> overwriteFile();
+        void closeFile();
+        Result<void, FileError> removeFile();
+        Result<void, FileError> truncateFile(std::size_t size);
+        Result<void, FileError> syncFile();
+
+        /* sync files deferred by BATCH_SYNC, then truncate and remove them */
+        Result<void, FileError> syncBatch();
+
+    private:
+        Result<std::uintmax_t, FileError> eraseFile(std::chrono::steady_clock::time_point beginTime);
+        void countFile(std::chrono::steady_clock::time_point beginTime);
+        Result<void, FileError> initEntry(UniqueFd&& parent, const std::string& newName, const std::string& fileName,
+                                          OverwriteMode newMode, const EraseOptions& newOptions);
+        Result<void, FileError> openPath();
+        Result<void, FileError> deferFile();
+        void showPermission(mode_t permission);
+        Result<void, FileError> prepareUring();
+        void prepareExtents();
+        Result<std::uintmax_t, FileError> probeBackend();
+
+        Result<void, FileError> runSchedule(std::span<const OverwritePass> schedule);
+        void preparePattern(const OverwritePass& pass);
+        Result<std::uintmax_t, FileError> overwriteBuffer(int pass);
+        Result<std::uintmax_t, FileError> overwriteExtent(const FileExtent& extent);
+        Result<std::uintmax_t, FileError> overwriteRanges(const std::vector<FileExtent>& passExtents);
+        Result<void, FileError> completeChunk(std::uintmax_t offset, std::uintmax_t length);
+        Result<void, FileError> discardFile();
+        Result<void, FileError> finishVerify(int pass);
+        Result<void, FileError> commitJournal(std::uint32_t pass, std::uintmax_t offset);
+        Result<std::uintmax_t, FileError> writeBuffer(std::uintmax_t offset, std::uintmax_t count, std::size_t tail);
+
+    private:
+        BufferPool& pool;
+        PooledBuffer buffer;
+        EraseEntry eraseEntry;
+
+        /* data of current pass, buffer of the file or one of cached patterns */
+        const std::uint8_t* pattern;
+        std::optional<OverwritePass> bufferPattern;
+        std::vector<PatternBuffer> patterns;
+        std::size_t patternBytes;
+
+        std::string name;
+        UniqueFd directory;
+        FileUniquePtr file;
+        std::size_t blockSize;
+        dev_t device;
+        std::vector<FileExtent> extents;
+        std::uintmax_t allocatedSize;
+
+        WriteBackend activeBackend;
+        std::unique_ptr<UringWriter> uring;
+        std::unique_ptr<DirectWriter> direct;
+        std::optional<MappedWriter> mapped;
+        std::optional<RangeWriter> ranges;
+        bool uringUnavailable;
+
+        PassVerifier verifier;
+        std::optional<JournalFile> journal;
+        std::uint32_t journalPass;
+        std::uintmax_t journalOffset;
+        std::vector<PendingFile> pendingFiles;
+
+        util::random::ChaCha20 random;
+    };
+}
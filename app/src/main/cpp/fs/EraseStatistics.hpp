@@ -0,0 +1,48 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "FileUnit.hpp"
+
+namespace kl::fs {
+    using fs::literals::operator""_mb;
+
+    struct EraseStatistics final {
+        std::uintmax_t countFiles;
+        std::uintmax_t countBytes;
+        std::chrono::nanoseconds duration;
+
+        EraseStatistics() : countFiles(0), countBytes(0), duration(0) {}
+        ~EraseStatistics() = default;
+
+        /* megabytes per second over the whole erase */
+        double throughput() const {
+            const double seconds = std::chrono::duration<double>(duration).count();
+            return seconds > 0.0 ? static_cast<double>(countBytes) / 1_mb / seconds : 0.0;
+        }
+    };
+}
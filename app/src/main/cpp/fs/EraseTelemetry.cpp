@@ -0,0 +1,162 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "EraseTelemetry.hpp"
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+
+#include "FileUtil.hpp"
+
+namespace kl::fs {
+
+    static UniqueFd openThreadIo() {
+        const std::string path = "/proc/self/task/" + std::to_string(::syscall(__NR_gettid)) + "/io";
+        return UniqueFd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    }
+
+    static std::uint64_t parseCounter(const char* text, const char* key) {
+        const char* found = std::strstr(text, key);
+        return found != nullptr ? std::strtoull(found + std::strlen(key), nullptr, 10) : 0;
+    }
+
+    /*
+     * Counters of thread are read by pread from descriptor kept per thread.
+     * The read is counted by the next sample, so deltas subtract one call.
+     */
+    TelemetrySample TelemetrySample::now() {
+        thread_local UniqueFd ioFd = openThreadIo();
+        char text[512] = {};
+        std::uint64_t countIoCalls = 0;
+
+        if (ioFd) {
+            const ssize_t count = ::pread(ioFd.get(), text, sizeof(text) - 1, 0);
+
+            if (count > 0) {
+                countIoCalls = parseCounter(text, "syscr:") + parseCounter(text, "syscw:");
+            }
+        }
+
+        return {std::chrono::steady_clock::now(), countIoCalls};
+    }
+
+    static std::uint64_t elapsedNanos(const TelemetrySample& begin, const TelemetrySample& end) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end.time - begin.time).count());
+    }
+
+    static std::uint64_t elapsedIoCalls(const TelemetrySample& begin, const TelemetrySample& end) {
+        return end.countIoCalls > begin.countIoCalls ? end.countIoCalls - begin.countIoCalls - 1 : 0;
+    }
+
+    void EraseTelemetry::addPhase(ErasePhase phase, const TelemetrySample& begin, const TelemetrySample& end) {
+        const auto index = static_cast<std::size_t>(phase);
+
+        phaseNanos[index] += elapsedNanos(begin, end);
+        phaseIoCalls[index] += elapsedIoCalls(begin, end);
+    }
+
+    void EraseTelemetry::addPass(int pass, const TelemetrySample& begin, const TelemetrySample& end,
+                                 std::uint64_t bytes, std::uint64_t excludedNanos, std::uint64_t excludedIoCalls) {
+        if (pass < 1 || static_cast<std::size_t>(pass) > MAX_PASSES) {
+            return;
+        }
+
+        const auto index = static_cast<std::size_t>(pass - 1);
+        const std::uint64_t nanos = elapsedNanos(begin, end);
+        const std::uint64_t ioCalls = elapsedIoCalls(begin, end);
+
+        passNanos[index] += nanos - std::min(nanos, excludedNanos);
+        passIoCalls[index] += ioCalls - std::min(ioCalls, excludedIoCalls);
+        passBytes[index] += bytes;
+        countBytes += bytes;
+        countPasses = std::max(countPasses, static_cast<std::uint32_t>(pass));
+    }
+
+    void EraseTelemetry::merge(const EraseTelemetry& other) {
+        totalNanos += other.totalNanos;
+        countBytes += other.countBytes;
+        countFiles += other.countFiles;
+        countPasses = std::max(countPasses, other.countPasses);
+
+        for (std::size_t i = 0; i < COUNT_PHASES; ++i) {
+            phaseNanos[i] += other.phaseNanos[i];
+            phaseIoCalls[i] += other.phaseIoCalls[i];
+        }
+
+        for (std::size_t i = 0; i < MAX_PASSES; ++i) {
+            passNanos[i] += other.passNanos[i];
+            passBytes[i] += other.passBytes[i];
+            passIoCalls[i] += other.passIoCalls[i];
+        }
+    }
+
+    std::uint64_t EraseTelemetry::countIoCalls() const {
+        return std::accumulate(phaseIoCalls.begin(), phaseIoCalls.end(), std::uint64_t{0}) +
+               std::accumulate(passIoCalls.begin(), passIoCalls.end(), std::uint64_t{0});
+    }
+
+    std::vector<std::int64_t> EraseTelemetry::toArray() const {
+        std::vector<std::int64_t> result;
+        result.reserve(HEADER_SIZE + COUNT_PHASES * PHASE_SIZE + countPasses * PASS_SIZE);
+
+        result.push_back(VERSION);
+        result.push_back(static_cast<std::int64_t>(totalNanos));
+        result.push_back(static_cast<std::int64_t>(countBytes));
+        result.push_back(static_cast<std::int64_t>(countIoCalls()));
+        result.push_back(static_cast<std::int64_t>(countFiles));
+        result.push_back(static_cast<std::int64_t>(countPasses));
+        result.push_back(static_cast<std::int64_t>(COUNT_PHASES));
+
+        for (std::size_t i = 0; i < COUNT_PHASES; ++i) {
+            result.push_back(static_cast<std::int64_t>(phaseNanos[i]));
+            result.push_back(static_cast<std::int64_t>(phaseIoCalls[i]));
+        }
+
+        for (std::size_t i = 0; i < countPasses; ++i) {
+            result.push_back(static_cast<std::int64_t>(passNanos[i]));
+            result.push_back(static_cast<std::int64_t>(passBytes[i]));
+            result.push_back(static_cast<std::int64_t>(passIoCalls[i]));
+        }
+
+        return result;
+    }
+
+    PhaseTimer::PhaseTimer(EraseTelemetry* telemetry, ErasePhase phase)
+        : telemetry(telemetry)
+        , phase(phase)
+        , begin(telemetry != nullptr ? TelemetrySample::now() : TelemetrySample{}) {
+    }
+
+    PhaseTimer::~PhaseTimer() {
+        if (telemetry != nullptr) {
+            telemetry->addPhase(phase, begin, TelemetrySample::now());
+        }
+    }
+}
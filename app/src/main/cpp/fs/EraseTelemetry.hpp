@@ -0,0 +1,122 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <util/enumeration/Enumeration.hpp>
+
+namespace kl::fs {
+
+    enum class ErasePhase : std::uint8_t {
+        OPEN_PHASE = 0,
+        PREPARE_PHASE = 1,
+        DISCARD_PHASE = 2,
+        SYNC_PHASE = 3,
+        CLOSE_PHASE = 4,
+        TRUNCATE_PHASE = 5,
+        RENAME_PHASE = 6,
+        UNLINK_PHASE = 7
+    };
+
+    inline constexpr util::enumeration::Enumeration<ErasePhase, 8> ERASE_PHASE = {
+        {ErasePhase::OPEN_PHASE, "OPEN_PHASE"},
+        {ErasePhase::PREPARE_PHASE, "PREPARE_PHASE"},
+        {ErasePhase::DISCARD_PHASE, "DISCARD_PHASE"},
+        {ErasePhase::SYNC_PHASE, "SYNC_PHASE"},
+        {ErasePhase::CLOSE_PHASE, "CLOSE_PHASE"},
+        {ErasePhase::TRUNCATE_PHASE, "TRUNCATE_PHASE"},
+        {ErasePhase::RENAME_PHASE, "RENAME_PHASE"},
+        {ErasePhase::UNLINK_PHASE, "UNLINK_PHASE"}
+    };
+
+    /* time and count of read/write calls (syscr + syscw of /proc) of calling thread */
+    struct TelemetrySample final {
+        std::chrono::steady_clock::time_point time;
+        std::uint64_t countIoCalls;
+
+        static TelemetrySample now();
+    };
+
+    /*
+     * Time in nanoseconds and read/write calls of each phase and pass, summed
+     * over erased files. Only read/write family is counted by kernel, so open,
+     * sync, truncate, rename, unlink, fallocate, io_uring and mapped writes
+     * show time without calls. Sync done inside a pass is counted only by
+     * SYNC_PHASE. Writes of parallel range threads aren't counted as calls.
+     */
+    struct EraseTelemetry final {
+        static constexpr std::size_t COUNT_PHASES = 8;
+        static constexpr std::size_t MAX_PASSES = 35;
+
+        /* layout of flat array, it's decoded by EraseTelemetry.java */
+        static constexpr std::int64_t VERSION = 1;
+        static constexpr std::size_t HEADER_SIZE = 7;
+        static constexpr std::size_t PHASE_SIZE = 2;
+        static constexpr std::size_t PASS_SIZE = 3;
+
+        std::uint64_t totalNanos = 0;
+        std::uint64_t countBytes = 0;
+        std::uint64_t countFiles = 0;
+        std::uint32_t countPasses = 0;
+
+        std::array<std::uint64_t, COUNT_PHASES> phaseNanos = {};
+        std::array<std::uint64_t, COUNT_PHASES> phaseIoCalls = {};
+        std::array<std::uint64_t, MAX_PASSES> passNanos = {};
+        std::array<std::uint64_t, MAX_PASSES> passBytes = {};
+        std::array<std::uint64_t, MAX_PASSES> passIoCalls = {};
+
+        void addPhase(ErasePhase phase, const TelemetrySample& begin, const TelemetrySample& end);
+        /* excluded part is already counted by phases nested into the pass */
+        void addPass(int pass, const TelemetrySample& begin, const TelemetrySample& end, std::uint64_t bytes,
+                     std::uint64_t excludedNanos, std::uint64_t excludedIoCalls);
+        void merge(const EraseTelemetry& other);
+
+        std::uint64_t countIoCalls() const;
+
+        /*
+         * [version, total ns, bytes, read/write calls, files, passes, phases],
+         * then (ns, calls) of each phase, then (ns, bytes, calls) of each pass
+         */
+        std::vector<std::int64_t> toArray() const;
+    };
+
+    /* add time of scope to phase, does nothing without telemetry */
+    class PhaseTimer final {
+    public:
+        PhaseTimer(EraseTelemetry* telemetry, ErasePhase phase);
+        ~PhaseTimer();
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        EraseTelemetry* telemetry;
+        ErasePhase phase;
+        TelemetrySample begin;
+    };
+}
@@ -33,20 +33,33 @@ namespace kl::fs {
     using namespace kl::util::property;
 
     class FileError final {
+    private:
+        /* declared before getter, which binds to it */
+        std::string message_;
+
     public:
-        explicit FileError(const std::string& text) : message(message_), message_(text) {}
-        explicit FileError(std::string&& text) : message(message_), message_(std::move(text)) {}
+        explicit FileError(const std::string& text) : message_(text), message(message_) {}
+        explicit FileError(std::string&& text) : message_(std::move(text)), message(message_) {}
 
         template<typename... Args>
-        explicit FileError(const char* formatter, Args&&... arguments) : message(message_) {
-            message_ = format(formatter, std::forward<Args>(arguments)...);
+        explicit FileError(const char* formatter, Args&&... arguments)
+            : message_(format(formatter, std::forward<Args>(arguments)...)), message(message_) {}
+
+        FileError(const FileError& other) : message_(other.message_), message(message_) {}
+        FileError(FileError&& other) noexcept : message_(std::move(other.message_)), message(message_) {}
+
+        FileError& operator=(const FileError& other) {
+            message_ = other.message_;
+            return *this;
+        }
+
+        FileError& operator=(FileError&& other) noexcept {
+            message_ = std::move(other.message_);
+            return *this;
         }
 
         ~FileError() = default;
 
         Getter<std::string&> message;
-
-    private:
-        std::string message_;
     };
 }
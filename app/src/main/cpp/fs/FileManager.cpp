@@ -25,8 +25,13 @@
 #include <chrono>
 #include <array>
 
-#include "FileEraser.hpp"
+#include "EraseSession.hpp"
+#include "DirectoryEraser.hpp"
+#include "EraseOptions.hpp"
+#include "EraseProgress.hpp"
 #include "OverwriteMode.hpp"
+#include "SyncPolicy.hpp"
+#include "WriteBackend.hpp"
 
 #include <jni/UniqueUtfChars.hpp>
 #include <util/nullability/NonNull.hpp>
@@ -35,61 +40,205 @@
 namespace {
     jclass fileExceptionClass = nullptr;
     jclass overwriteModeClass = nullptr;
+    jclass eraseResultClass = nullptr;
+    jclass eraseOptionsClass = nullptr;
+    jclass writeBackendClass = nullptr;
+    jclass syncPolicyClass = nullptr;
 
     jfieldID simpleModeFieldId = nullptr;
     jmethodID nameMethodId = nullptr;
+    jmethodID eraseResultConstructorId = nullptr;
+
+    jfieldID backendFieldId = nullptr;
+    jfieldID queueDepthFieldId = nullptr;
+    jfieldID mmapThresholdFieldId = nullptr;
+    jfieldID patternPassFieldId = nullptr;
+    jfieldID verifyFieldId = nullptr;
+    jfieldID progressFieldId = nullptr;
+    jfieldID progressHandleFieldId = nullptr;
+    jfieldID syncPolicyFieldId = nullptr;
+    jfieldID syncBatchSizeFieldId = nullptr;
+    jfieldID rangeThreadsFieldId = nullptr;
+    jfieldID rangeThresholdFieldId = nullptr;
+    jfieldID resumableFieldId = nullptr;
+    jfieldID telemetryFieldId = nullptr;
+    jfieldID tuneChunksFieldId = nullptr;
+    jmethodID backendNameMethodId = nullptr;
+    jmethodID syncPolicyNameMethodId = nullptr;
+
+    /* shared between concurrent eraseFile calls */
+    kl::fs::BufferPool bufferPool(4);
+    kl::fs::ChunkTuner chunkTuner;
+    kl::fs::EraseJournal eraseJournal;
 }
 
 using namespace kl::util::nullability;
 
 namespace kl::fs {
 
-    jlong nativeEraseFile(JNIEnv* rawEnv, jclass clazz, jstring jvmPath, jobject jvmOverwriteMode) {
-        auto env = makeNonNull(rawEnv);
-        auto& eraser = FileEraser::instance();
-
-        jni::UniqueUtfChars jvmUniquePath(env, jvmPath);
-        std::filesystem::path filePath(static_cast<const char*>(jvmUniquePath.get()));
-
+    static std::optional<OverwriteMode> toOverwriteMode(const NonNull<JNIEnv*>& env, jobject jvmOverwriteMode) {
         auto modeName = (jstring) env->CallObjectMethod(jvmOverwriteMode, nameMethodId);
         jni::UniqueUtfChars jvmModeName(env, modeName);
 
-        auto beginTime = std::chrono::steady_clock::now();
+        return OVERWRITE_MODE.value(jvmModeName.get());
+    }
+
+    /* reference of running erase to EraseProgress retained by toEraseOptions */
+    class ProgressReference final {
+    public:
+        explicit ProgressReference(EraseProgress* progress) : progress(progress) {}
+        ~ProgressReference() {
+            if (progress != nullptr && progress->release()) {
+                delete progress;
+            }
+        }
+
+        ProgressReference(const ProgressReference&) = delete;
+        ProgressReference& operator=(const ProgressReference&) = delete;
+
+    private:
+        EraseProgress* progress;
+    };
+
+    /* progress of returned options is retained, caller releases it with ProgressReference */
+    static Result<EraseOptions, FileError> toEraseOptions(const NonNull<JNIEnv*>& env, jobject jvmOptions) {
+        EraseOptions options;
+
+        /* legacy overloads keep their flush-only behaviour, no sync per file */
+        if (jvmOptions == nullptr) {
+            options.syncPolicy = SyncPolicy::NO_SYNC;
+            return options;
+        }
+
+        /* calibration writes tens of MB on first file of each device, so it is opt-in */
+        if (env->GetBooleanField(jvmOptions, tuneChunksFieldId) == JNI_TRUE) {
+            options.chunkTuner = &chunkTuner;
+        }
+
+        jobject jvmBackend = env->GetObjectField(jvmOptions, backendFieldId);
+        auto backendName = (jstring) env->CallObjectMethod(jvmBackend, backendNameMethodId);
+        jni::UniqueUtfChars jvmBackendName(env, backendName);
+
+        if (auto backend = WRITE_BACKEND.value(jvmBackendName.get()); backend.has_value()) {
+            options.backend = *backend;
+        } else {
+            return FileError("Set unknown WriteBackend");
+        }
+
+        if (jint queueDepth = env->GetIntField(jvmOptions, queueDepthFieldId); queueDepth > 0) {
+            options.queueDepth = static_cast<std::uint32_t>(queueDepth);
+        } else {
+            return FileError("Queue depth must be positive");
+        }
+
+        if (jlong mmapThreshold = env->GetLongField(jvmOptions, mmapThresholdFieldId); mmapThreshold >= 0) {
+            options.mmapThreshold = static_cast<std::uintmax_t>(mmapThreshold);
+        } else {
+            return FileError("Mmap threshold can't be negative");
+        }
+
+        jobject jvmSyncPolicy = env->GetObjectField(jvmOptions, syncPolicyFieldId);
+        auto syncPolicyName = (jstring) env->CallObjectMethod(jvmSyncPolicy, syncPolicyNameMethodId);
+        jni::UniqueUtfChars jvmSyncPolicyName(env, syncPolicyName);
+
+        if (auto syncPolicy = SYNC_POLICY.value(jvmSyncPolicyName.get()); syncPolicy.has_value()) {
+            options.syncPolicy = *syncPolicy;
+        } else {
+            return FileError("Set unknown SyncPolicy");
+        }
+
+        if (jint syncBatchSize = env->GetIntField(jvmOptions, syncBatchSizeFieldId); syncBatchSize > 0) {
+            options.syncBatchSize = static_cast<std::uint32_t>(syncBatchSize);
+        } else {
+            return FileError("Sync batch size must be positive");
+        }
+
+        if (jint rangeThreads = env->GetIntField(jvmOptions, rangeThreadsFieldId); rangeThreads > 0) {
+            options.rangeThreads = static_cast<std::uint32_t>(rangeThreads);
+        } else {
+            return FileError("Range threads must be positive");
+        }
+
+        if (jlong rangeThreshold = env->GetLongField(jvmOptions, rangeThresholdFieldId); rangeThreshold >= 0) {
+            options.rangeThreshold = static_cast<std::uintmax_t>(rangeThreshold);
+        } else {
+            return FileError("Range threshold can't be negative");
+        }
 
-        auto overwriteMode = OVERWRITE_MODE.value(jvmModeName.get());
+        options.patternPass = env->GetBooleanField(jvmOptions, patternPassFieldId) == JNI_TRUE;
+        options.verify = env->GetBooleanField(jvmOptions, verifyFieldId) == JNI_TRUE;
+
+        if (env->GetBooleanField(jvmOptions, resumableFieldId) == JNI_TRUE) {
+            options.journal = &eraseJournal;
+        }
+
+        if (jobject jvmProgress = env->GetObjectField(jvmOptions, progressFieldId); jvmProgress != nullptr) {
+            /* EraseProgress.close() is synchronized, so handle can't be destroyed before retain */
+            env->MonitorEnter(jvmProgress);
+            jlong handle = env->GetLongField(jvmProgress, progressHandleFieldId);
+
+            if (handle != 0) {
+                options.progress = reinterpret_cast<EraseProgress*>(handle);
+                options.progress->retain();
+            }
+
+            env->MonitorExit(jvmProgress);
+
+            if (handle == 0) {
+                return FileError("EraseProgress is already closed");
+            }
+        }
+
+        return options;
+    }
+
+    /* throw FileException and return false on error */
+    static bool eraseFileWith(const NonNull<JNIEnv*>& env, jstring jvmPath, jobject jvmOverwriteMode,
+                              jobject jvmOptions, EraseTelemetry* telemetry) {
+        EraseSession session(bufferPool);
+
+        jni::UniqueUtfChars jvmUniquePath(env, jvmPath);
+        std::filesystem::path filePath(static_cast<const char*>(jvmUniquePath.get()));
+
+        auto overwriteMode = toOverwriteMode(env, jvmOverwriteMode);
 
         if (!overwriteMode.has_value()) {
             env->ThrowNew(fileExceptionClass, "Set unknown OverwriteMode");
-            return -1LL;
+            return false;
         }
 
-        if (auto result = eraser.init(filePath, *overwriteMode); result.hasError()) {
-            std::string& message = result.error().message;
-            env->ThrowNew(fileExceptionClass, message.c_str());
-            return -1LL;
-        }
+        auto options = toEraseOptions(env, jvmOptions);
 
-        if (auto result = eraser.checkPermission(); result.hasError()) {
-            std::string& message = result.error().message;
+        if (options.hasError()) {
+            std::string& message = options.error().message;
             env->ThrowNew(fileExceptionClass, message.c_str());
-            return -1LL;
+            return false;
         }
 
-        if (auto result = eraser.overwriteFile(); result.hasError()) {
+        ProgressReference progressReference(options.value().progress);
+        options.value().telemetry = telemetry;
+
+        if (auto result = session.erase(filePath, *overwriteMode, options.value()); result.hasError()) {
             std::string& message = result.error().message;
             env->ThrowNew(fileExceptionClass, message.c_str());
-            return -1LL;
+            return false;
         }
 
-        if (auto result = eraser.truncateFile(0); result.hasError()) {
+        if (auto result = session.syncBatch(); result.hasError()) {
             std::string& message = result.error().message;
             env->ThrowNew(fileExceptionClass, message.c_str());
-            return -1LL;
+            return false;
         }
 
-        if (auto result = eraser.removeFile(); result.hasError()) {
-            std::string& message = result.error().message;
-            env->ThrowNew(fileExceptionClass, message.c_str());
+        return true;
+    }
+
+    jlong nativeEraseFileWithOptions(JNIEnv* rawEnv, jclass clazz, jstring jvmPath,
+                                     jobject jvmOverwriteMode, jobject jvmOptions) {
+        auto env = makeNonNull(rawEnv);
+        auto beginTime = std::chrono::steady_clock::now();
+
+        if (!eraseFileWith(env, jvmPath, jvmOverwriteMode, jvmOptions, nullptr)) {
             return -1LL;
         }
 
@@ -98,6 +247,35 @@ namespace kl::fs {
         return std::chrono::duration_cast<std::chrono::milliseconds>(endTime - beginTime).count();
     }
 
+    static jlongArray toJvmArray(const NonNull<JNIEnv*>& env, const EraseTelemetry& telemetry) {
+        const std::vector<std::int64_t> values = telemetry.toArray();
+        jlongArray jvmValues = env->NewLongArray(static_cast<jsize>(values.size()));
+
+        if (jvmValues != nullptr) {
+            static_assert(sizeof(jlong) == sizeof(std::int64_t));
+            env->SetLongArrayRegion(jvmValues, 0, static_cast<jsize>(values.size()),
+                                    reinterpret_cast<const jlong*>(values.data()));
+        }
+
+        return jvmValues;
+    }
+
+    jlongArray nativeEraseFileWithTelemetry(JNIEnv* rawEnv, jclass clazz, jstring jvmPath,
+                                            jobject jvmOverwriteMode, jobject jvmOptions) {
+        auto env = makeNonNull(rawEnv);
+        EraseTelemetry telemetry;
+
+        if (!eraseFileWith(env, jvmPath, jvmOverwriteMode, jvmOptions, &telemetry)) {
+            return nullptr;
+        }
+
+        return toJvmArray(env, telemetry);
+    }
+
+    jlong nativeEraseFile(JNIEnv* rawEnv, jclass clazz, jstring jvmPath, jobject jvmOverwriteMode) {
+        return nativeEraseFileWithOptions(rawEnv, clazz, jvmPath, jvmOverwriteMode, nullptr);
+    }
+
     jlong nativeEraseFileWithDefaultMode(JNIEnv* rawEnv, jclass clazz, jstring jvmPath) {
         auto env = makeNonNull(rawEnv);
         jobject simpleModeObject = env->GetStaticObjectField(overwriteModeClass, simpleModeFieldId);
@@ -105,42 +283,71 @@ namespace kl::fs {
         return nativeEraseFile(env, clazz, jvmPath, simpleModeObject);
     }
 
-    jlong nativeEraseDirectory(JNIEnv* rawEnv, jclass clazz, jstring jvmPath, jobject jvmOverwriteMode, jboolean isRecursive) {
+    jobject nativeEraseDirectoryWithOptions(JNIEnv* rawEnv, jclass clazz, jstring jvmPath, jobject jvmOverwriteMode,
+                                            jobject jvmOptions, jboolean isRecursive, jint jvmCountThreads) {
         auto env = makeNonNull(rawEnv);
         const auto jvmUniquePath = jni::UniqueUtfChars(env, jvmPath);
         const auto folder = std::filesystem::path(static_cast<const char*>(jvmUniquePath.get()));
 
-        jstring filePath = nullptr;
-        auto beginTime = std::chrono::steady_clock::now();
+        auto overwriteMode = toOverwriteMode(env, jvmOverwriteMode);
 
-        if (!std::filesystem::exists(folder)) {
-            env->ThrowNew(fileExceptionClass, "Directory doesn't exist");
-            return -1LL;
+        if (!overwriteMode.has_value()) {
+            env->ThrowNew(fileExceptionClass, "Set unknown OverwriteMode");
+            return nullptr;
         }
 
-        if (!std::filesystem::is_directory(folder)) {
-            env->ThrowNew(fileExceptionClass, "Path doesn't directory");
-            return -1LL;
+        auto options = toEraseOptions(env, jvmOptions);
+
+        if (options.hasError()) {
+            std::string& message = options.error().message;
+            env->ThrowNew(fileExceptionClass, message.c_str());
+            return nullptr;
         }
 
-        if (isRecursive) {
-            for (const auto& item : std::filesystem::recursive_directory_iterator(folder)) {
-                filePath = env->NewStringUTF(item.path().c_str());
+        ProgressReference progressReference(options.value().progress);
 
-                if (!std::filesystem::is_directory(item.path())) {
-                    if (!nativeEraseFile(env, clazz, filePath, jvmOverwriteMode)) {
-                        return -1LL;
-                    }
-                }
-            }
-        } else {
-            for (const auto& item : std::filesystem::directory_iterator(folder)) {
-                filePath = env->NewStringUTF(item.path().c_str());
+        if (jvmCountThreads < 0) {
+            env->ThrowNew(fileExceptionClass, "Count of threads can't be negative");
+            return nullptr;
+        }
 
-                if (!nativeEraseFile(env, clazz, filePath, jvmOverwriteMode)) {
-                    return -1LL;
-                }
-            }
+        EraseTelemetry telemetry;
+
+        if (jvmOptions != nullptr && env->GetBooleanField(jvmOptions, telemetryFieldId) == JNI_TRUE) {
+            options.value().telemetry = &telemetry;
+        }
+
+        DirectoryEraser eraser(static_cast<std::size_t>(jvmCountThreads));
+        auto result = eraser.erase(folder, *overwriteMode, options.value(), isRecursive);
+
+        if (result.hasError()) {
+            std::string& message = result.error().message;
+            env->ThrowNew(fileExceptionClass, message.c_str());
+            return nullptr;
+        }
+
+        const EraseStatistics& statistics = result.value();
+
+        return env->NewObject(eraseResultClass, eraseResultConstructorId,
+                static_cast<jlong>(statistics.countFiles), static_cast<jlong>(statistics.countBytes),
+                std::chrono::duration_cast<std::chrono::milliseconds>(statistics.duration).count(),
+                statistics.throughput(), options.value().telemetry != nullptr ? toJvmArray(env, telemetry) : nullptr);
+    }
+
+    jobject nativeEraseDirectoryInParallel(JNIEnv* rawEnv, jclass clazz, jstring jvmPath, jobject jvmOverwriteMode,
+                                           jboolean isRecursive, jint jvmCountThreads) {
+        return nativeEraseDirectoryWithOptions(rawEnv, clazz, jvmPath, jvmOverwriteMode,
+                                               nullptr, isRecursive, jvmCountThreads);
+    }
+
+    jlong nativeEraseDirectory(JNIEnv* rawEnv, jclass clazz, jstring jvmPath, jobject jvmOverwriteMode, jboolean isRecursive) {
+        auto env = makeNonNull(rawEnv);
+        auto beginTime = std::chrono::steady_clock::now();
+
+        jobject eraseResult = nativeEraseDirectoryInParallel(env, clazz, jvmPath, jvmOverwriteMode, isRecursive, 0);
+
+        if (eraseResult == nullptr) {
+            return -1LL;
         }
 
         auto endTime = std::chrono::steady_clock::now();
@@ -155,16 +362,104 @@ namespace kl::fs {
         return nativeEraseDirectory(env, clazz, jvmPath, simpleModeObject, isRecursive);
     }
 
-    constexpr std::array<JNINativeMethod, 4> JNI_METHODS = {{
+    void nativeSetChunkCache(JNIEnv* rawEnv, jclass clazz, jstring jvmPath) {
+        auto env = makeNonNull(rawEnv);
+        jni::UniqueUtfChars jvmUniquePath(env, jvmPath);
+
+        chunkTuner.setCachePath(static_cast<const char*>(jvmUniquePath.get()));
+    }
+
+    void nativeSetJournalDirectory(JNIEnv* rawEnv, jclass clazz, jstring jvmPath) {
+        auto env = makeNonNull(rawEnv);
+        jni::UniqueUtfChars jvmUniquePath(env, jvmPath);
+
+        eraseJournal.setDirectory(static_cast<const char*>(jvmUniquePath.get()));
+    }
+
+    jlong nativeCreateProgress(JNIEnv* rawEnv, jclass clazz) {
+        return reinterpret_cast<jlong>(new EraseProgress());
+    }
+
+    /* running erases keep own references, so progress is deleted by the last of them */
+    void nativeDestroyProgress(JNIEnv* rawEnv, jclass clazz, jlong handle) {
+        if (auto* progress = reinterpret_cast<EraseProgress*>(handle); progress != nullptr && progress->release()) {
+            delete progress;
+        }
+    }
+
+    jlong nativeCountProgressBytes(JNIEnv* rawEnv, jclass clazz, jlong handle) {
+        if (handle == 0) {
+            return 0;
+        }
+
+        return static_cast<jlong>(reinterpret_cast<EraseProgress*>(handle)->countBytes.load(std::memory_order_relaxed));
+    }
+
+    jlong nativeCountProgressFiles(JNIEnv* rawEnv, jclass clazz, jlong handle) {
+        if (handle == 0) {
+            return 0;
+        }
+
+        return static_cast<jlong>(reinterpret_cast<EraseProgress*>(handle)->countFiles.load(std::memory_order_relaxed));
+    }
+
+    jint nativeProgressPass(JNIEnv* rawEnv, jclass clazz, jlong handle) {
+        if (handle == 0) {
+            return 0;
+        }
+
+        return reinterpret_cast<EraseProgress*>(handle)->pass.load(std::memory_order_relaxed);
+    }
+
+    void nativeCancelProgress(JNIEnv* rawEnv, jclass clazz, jlong handle) {
+        if (handle == 0) {
+            return;
+        }
+
+        reinterpret_cast<EraseProgress*>(handle)->cancel();
+    }
+
+    jboolean nativeIsProgressCancelled(JNIEnv* rawEnv, jclass clazz, jlong handle) {
+        if (handle == 0) {
+            return JNI_FALSE;
+        }
+
+        return reinterpret_cast<EraseProgress*>(handle)->isCancelled() ? JNI_TRUE : JNI_FALSE;
+    }
+
+    constexpr std::array<JNINativeMethod, 7> PROGRESS_JNI_METHODS = {{
+        {"create", "()J", (void*)nativeCreateProgress},
+        {"destroy", "(J)V", (void*)nativeDestroyProgress},
+        {"countBytes", "(J)J", (void*)nativeCountProgressBytes},
+        {"countFiles", "(J)J", (void*)nativeCountProgressFiles},
+        {"pass", "(J)I", (void*)nativeProgressPass},
+        {"cancel", "(J)V", (void*)nativeCancelProgress},
+        {"isCancelled", "(J)Z", (void*)nativeIsProgressCancelled}
+    }};
+
+    constexpr std::array<JNINativeMethod, 10> JNI_METHODS = {{
         {"eraseFile", "(Ljava/lang/String;)J", (void*)nativeEraseFileWithDefaultMode},
         {"eraseFile", "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;)J", (void*)nativeEraseFile},
+        {"eraseFile", "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;Lorg/kl/firearrow/fs/EraseOptions;)J",
+         (void*)nativeEraseFileWithOptions},
+        {"eraseFileWithTelemetry",
+         "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;Lorg/kl/firearrow/fs/EraseOptions;)[J",
+         (void*)nativeEraseFileWithTelemetry},
         {"eraseDirectory", "(Ljava/lang/String;Z)J", (void*)nativeEraseDirectoryWithDefaultMode},
-        {"eraseDirectory", "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;Z)J", (void*)nativeEraseDirectory}
+        {"eraseDirectory", "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;Z)J", (void*)nativeEraseDirectory},
+        {"eraseDirectory", "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;ZI)Lorg/kl/firearrow/fs/EraseResult;",
+         (void*)nativeEraseDirectoryInParallel},
+        {"eraseDirectory",
+         "(Ljava/lang/String;Lorg/kl/firearrow/fs/OverwriteMode;Lorg/kl/firearrow/fs/EraseOptions;ZI)Lorg/kl/firearrow/fs/EraseResult;",
+         (void*)nativeEraseDirectoryWithOptions},
+        {"setChunkCache", "(Ljava/lang/String;)V", (void*)nativeSetChunkCache},
+        {"setJournalDirectory", "(Ljava/lang/String;)V", (void*)nativeSetJournalDirectory}
     }};
 }
 
 jint registerFileManager(JNIEnv* rawEnv) {
     using kl::fs::JNI_METHODS;
+    using kl::fs::PROGRESS_JNI_METHODS;
     auto env = makeNonNull(rawEnv);
 
     jclass temporaryClass = env->FindClass("org/kl/firearrow/fs/FileException");
@@ -173,8 +468,44 @@ jint registerFileManager(JNIEnv* rawEnv) {
     temporaryClass = env->FindClass("org/kl/firearrow/fs/OverwriteMode");
     overwriteModeClass = (jclass) env->NewGlobalRef(temporaryClass);
 
+    temporaryClass = env->FindClass("org/kl/firearrow/fs/EraseResult");
+    eraseResultClass = (jclass) env->NewGlobalRef(temporaryClass);
+
+    temporaryClass = env->FindClass("org/kl/firearrow/fs/EraseOptions");
+    eraseOptionsClass = (jclass) env->NewGlobalRef(temporaryClass);
+
+    temporaryClass = env->FindClass("org/kl/firearrow/fs/WriteBackend");
+    writeBackendClass = (jclass) env->NewGlobalRef(temporaryClass);
+
+    temporaryClass = env->FindClass("org/kl/firearrow/fs/SyncPolicy");
+    syncPolicyClass = (jclass) env->NewGlobalRef(temporaryClass);
+
     simpleModeFieldId = env->GetStaticFieldID(overwriteModeClass, "SIMPLE_MODE", "Lorg/kl/firearrow/fs/OverwriteMode;");
     nameMethodId = env->GetMethodID(overwriteModeClass, "name", "()Ljava/lang/String;");
+    eraseResultConstructorId = env->GetMethodID(eraseResultClass, "<init>", "(JJJD[J)V");
+
+    backendFieldId = env->GetFieldID(eraseOptionsClass, "backend", "Lorg/kl/firearrow/fs/WriteBackend;");
+    queueDepthFieldId = env->GetFieldID(eraseOptionsClass, "queueDepth", "I");
+    mmapThresholdFieldId = env->GetFieldID(eraseOptionsClass, "mmapThreshold", "J");
+    patternPassFieldId = env->GetFieldID(eraseOptionsClass, "patternPass", "Z");
+    verifyFieldId = env->GetFieldID(eraseOptionsClass, "verify", "Z");
+    progressFieldId = env->GetFieldID(eraseOptionsClass, "progress", "Lorg/kl/firearrow/fs/EraseProgress;");
+    syncPolicyFieldId = env->GetFieldID(eraseOptionsClass, "syncPolicy", "Lorg/kl/firearrow/fs/SyncPolicy;");
+    syncBatchSizeFieldId = env->GetFieldID(eraseOptionsClass, "syncBatchSize", "I");
+    rangeThreadsFieldId = env->GetFieldID(eraseOptionsClass, "rangeThreads", "I");
+    rangeThresholdFieldId = env->GetFieldID(eraseOptionsClass, "rangeThreshold", "J");
+    resumableFieldId = env->GetFieldID(eraseOptionsClass, "resumable", "Z");
+    telemetryFieldId = env->GetFieldID(eraseOptionsClass, "telemetry", "Z");
+    tuneChunksFieldId = env->GetFieldID(eraseOptionsClass, "tuneChunks", "Z");
+    backendNameMethodId = env->GetMethodID(writeBackendClass, "name", "()Ljava/lang/String;");
+    syncPolicyNameMethodId = env->GetMethodID(syncPolicyClass, "name", "()Ljava/lang/String;");
+
+    jclass eraseProgressClass = env->FindClass("org/kl/firearrow/fs/EraseProgress");
+    progressHandleFieldId = env->GetFieldID(eraseProgressClass, "handle", "J");
+
+    if (env->RegisterNatives(eraseProgressClass, PROGRESS_JNI_METHODS.data(), PROGRESS_JNI_METHODS.size()) != JNI_OK) {
+        return JNI_ERR;
+    }
 
     jclass fileManagerClass = env->FindClass("org/kl/firearrow/fs/FileManager");
     return env->RegisterNatives(fileManagerClass, JNI_METHODS.data(), JNI_METHODS.size());
@@ -184,6 +515,10 @@ void unregisterFileManager(JNIEnv* rawEnv) {
     auto env = makeNonNull(rawEnv);
 
     env->DeleteGlobalRef(overwriteModeClass);
+    env->DeleteGlobalRef(eraseResultClass);
+    env->DeleteGlobalRef(eraseOptionsClass);
+    env->DeleteGlobalRef(writeBackendClass);
+    env->DeleteGlobalRef(syncPolicyClass);
     env->DeleteGlobalRef(fileExceptionClass);
 }
 
@@ -25,8 +25,12 @@
 #include "FileUtil.hpp"
 
 #include <sys/stat.h>
+#include <sys/vfs.h>
 #include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 
 namespace kl::fs {
 
@@ -36,35 +40,111 @@ namespace kl::fs {
         }
     }
 
-    Result<FileUniquePtr, FileError> makeOpenFile(const std::string& path, const std::string& mode) {
-        FILE *handle = ::fopen(path.c_str(), mode.c_str());
+    UniqueFd& UniqueFd::operator=(UniqueFd&& other) noexcept {
+        if (this != &other) {
+            reset(other.release());
+        }
+
+        return *this;
+    }
 
-        if (handle == nullptr) {
-            return FileError("Can't open file %s, error %s", path.c_str(), ::strerror(errno));
+    int UniqueFd::release() noexcept {
+        const int result = fd;
+        fd = -1;
+        return result;
+    }
+
+    void UniqueFd::reset(int newFd) noexcept {
+        if (fd != -1) {
+            ::close(fd);
         }
 
-        return FileUniquePtr(handle);
+        fd = newFd;
     }
 
-    Result<std::size_t, FileError> blockSize(const std::string& path) {
-        struct stat fileInfo = {};
+    Result<std::uintmax_t, FileError> writePattern(int fd, const std::uint8_t* pattern, std::size_t patternSize,
+                                                   std::uintmax_t offset, std::uintmax_t length) {
+        std::uintmax_t written = 0;
+
+        while (written < length) {
+            std::size_t left = static_cast<std::size_t>(std::min<std::uintmax_t>(patternSize, length - written));
+            const std::uint8_t* data = pattern;
 
-        if (::lstat(path.c_str(), &fileInfo) == -1) {
-            return FileError("Can't get file %s status , error %s", path.c_str(), ::strerror(errno));
+            while (left > 0) {
+                const ssize_t count = ::pwrite(fd, data, left, static_cast<off_t>(offset + written));
+
+                if (count == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    return FileError("Fail write buffer to file, error %s", ::strerror(errno));
+                }
+
+                data += count;
+                left -= static_cast<std::size_t>(count);
+                written += static_cast<std::uintmax_t>(count);
+            }
         }
 
-        std::size_t size = fileInfo.st_blksize;
+        return written;
+    }
+
+    Result<std::vector<FileExtent>, FileError> findExtents(int fd, std::uintmax_t fileSize, std::size_t alignment) {
+        std::vector<FileExtent> extents;
+        std::uintmax_t offset = 0;
+
+        while (offset < fileSize) {
+            const off_t data = ::lseek(fd, static_cast<off_t>(offset), SEEK_DATA);
+
+            if (data == -1) {
+                if (errno == ENXIO) {
+                    break; /* only hole up to end of file */
+                }
+
+                if (errno == EINVAL || errno == EOPNOTSUPP) {
+                    return std::vector<FileExtent>{{0, fileSize}};
+                }
+
+                return FileError("Can't seek data in file, error %s", ::strerror(errno));
+            }
+
+            if (static_cast<std::uintmax_t>(data) >= fileSize) {
+                break;
+            }
+
+            const off_t hole = ::lseek(fd, data, SEEK_HOLE);
+
+            if (hole == -1) {
+                return FileError("Can't seek hole in file, error %s", ::strerror(errno));
+            }
+
+            const auto dataEnd = std::min(static_cast<std::uintmax_t>(hole), fileSize);
+            const std::uintmax_t begin = static_cast<std::uintmax_t>(data) / alignment * alignment;
+            const std::uintmax_t end = std::min((dataEnd + alignment - 1) / alignment * alignment, fileSize);
+
+            if (!extents.empty() && begin <= extents.back().offset + extents.back().length) {
+                extents.back().length = end - extents.back().offset;
+            } else {
+                extents.push_back({begin, end - begin});
+            }
+
+            offset = dataEnd;
+        }
 
-        return size > 16 ? size : 512;
+        return extents;
     }
 
-    Result<std::uint32_t, FileError> countHardLinks(const std::string& path) {
-        struct stat fileInfo = {};
+    bool overwritesInPlace(int fd) {
+        constexpr decltype(statfs::f_type) BTRFS_MAGIC = 0x9123683E;
+        constexpr decltype(statfs::f_type) F2FS_MAGIC = 0xF2F52010;
+        struct statfs fileSystemInfo = {};
 
-        if (::lstat(path.c_str(), &fileInfo) < 0) {
-            return FileError("Can't get file %s status, error %s", path.c_str(), ::strerror(errno));
+        /* unknown filesystem is treated as not overwriting in place */
+        if (::fstatfs(fd, &fileSystemInfo) == -1) {
+            return false;
         }
 
-        return static_cast<std::uint32_t>(fileInfo.st_nlink);
+        return fileSystemInfo.f_type != BTRFS_MAGIC && fileSystemInfo.f_type != F2FS_MAGIC;
     }
-}
\ No newline at end of file
+}
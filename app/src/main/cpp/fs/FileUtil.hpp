@@ -25,6 +25,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include <util/error/Result.hpp>
 #include "FileError.hpp"
@@ -38,10 +39,52 @@ namespace kl::fs {
 
     using FileUniquePtr = std::unique_ptr<FILE, FileDeleter>;
 
-    Result<FileUniquePtr, FileError> makeOpenFile(const std::string& path, const std::string& mode);
+    /* owner of raw file descriptor */
+    class UniqueFd final {
+    public:
+        UniqueFd() noexcept : fd(-1) {}
+        explicit UniqueFd(int fd) noexcept : fd(fd) {}
+        ~UniqueFd() { reset(); }
 
-    Result<std::size_t, FileError> blockSize(const std::string& path);
-    Result<std::uint32_t, FileError> countHardLinks(const std::string& path);
+        UniqueFd(const UniqueFd&) = delete;
+        UniqueFd& operator=(const UniqueFd&) = delete;
+
+        UniqueFd(UniqueFd&& other) noexcept : fd(other.release()) {}
+        UniqueFd& operator=(UniqueFd&& other) noexcept;
+
+        int get() const noexcept { return fd; }
+        int release() noexcept;
+        void reset(int newFd = -1) noexcept;
+
+        explicit operator bool() const noexcept { return fd != -1; }
+
+    private:
+        int fd;
+    };
+
+    /* allocated range of file, holes between extents have no data */
+    struct FileExtent final {
+        std::uintmax_t offset;
+        std::uintmax_t length;
+    };
+
+    /* pwrite repeated pattern to [offset, offset + length) */
+    Result<std::uintmax_t, FileError> writePattern(int fd, const std::uint8_t* pattern, std::size_t patternSize,
+                                                   std::uintmax_t offset, std::uintmax_t length);
+
+    /*
+     * Find data extents with SEEK_DATA/SEEK_HOLE, bounds are widened to alignment
+     * and adjacent extents are merged. Whole file is one extent when filesystem
+     * doesn't report holes.
+     */
+    Result<std::vector<FileExtent>, FileError> findExtents(int fd, std::uintmax_t fileSize, std::size_t alignment);
+
+    /*
+     * Whether filesystem overwrites blocks in place. Copy-on-write and log-structured
+     * ones (btrfs, f2fs) allocate new blocks even for overwrite, so it can fail with
+     * ENOSPC, which arrives as SIGBUS on mapped pages.
+     */
+    bool overwritesInPlace(int fd);
 }
 
 
@@ -0,0 +1,91 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "MappedWriter.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+
+namespace kl::fs {
+
+    MappedWriter::MappedWriter(int fd, std::size_t patternSize, bool syncWindows, std::size_t windowSize)
+        : fd(fd)
+        , patternSize(patternSize)
+        , pageSize_(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)))
+        , granularity_(std::lcm(patternSize, pageSize_))
+        , windowSize(std::max(windowSize / granularity_, std::size_t(1)) * granularity_)
+        , syncWindows(syncWindows) {
+    }
+
+    Result<std::uintmax_t, FileError> MappedWriter::writeRange(const std::uint8_t* pattern, std::uintmax_t offset,
+                                                               std::uintmax_t length) {
+        const std::uintmax_t end = offset + length;
+        std::uintmax_t written = 0;
+
+        if (offset % pageSize_ != 0) {
+            return FileError("Offset %ju isn't aligned to %zu bytes for mapped write", offset, pageSize_);
+        }
+
+        while (offset < end) {
+            const auto size = static_cast<std::size_t>(std::min<std::uintmax_t>(windowSize, end - offset));
+            void* window = ::mmap(nullptr, size, PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(offset));
+
+            if (window == MAP_FAILED) {
+                return FileError("Can't map file window, error %s", ::strerror(errno));
+            }
+
+            ::madvise(window, size, MADV_SEQUENTIAL);
+            fillWindow(static_cast<std::uint8_t*>(window), pattern, size);
+
+            const bool synced = !syncWindows || ::msync(window, size, MS_SYNC) == 0;
+            const int error = errno;
+            ::munmap(window, size);
+
+            if (!synced) {
+                return FileError("Can't sync file window, error %s", ::strerror(error));
+            }
+
+            offset += size;
+            written += size;
+        }
+
+        return written;
+    }
+
+    void MappedWriter::fillWindow(std::uint8_t* window, const std::uint8_t* pattern, std::size_t length) const {
+        std::size_t filled = std::min(patternSize, length);
+        std::memcpy(window, pattern, filled);
+
+        /* double filled prefix, so whole window takes log(n) vectorized memcpy calls */
+        while (filled < length) {
+            const std::size_t count = std::min(filled, length - filled);
+            std::memcpy(window + filled, window, count);
+            filled += count;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "FileError.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+
+    /*
+     * Overwrite through shared memory mappings of the file. Windows are
+     * filled with repeated pattern and optionally synced with msync before unmap,
+     * otherwise dirty pages stay in page cache until writeback or fdatasync.
+     * Error of writeback (EIO, or ENOSPC on btrfs and f2fs, which don't overwrite
+     * in place) arrives as SIGBUS and kills the process, so explicit MMAP_BACKEND
+     * is safe only on filesystems which overwrite in place.
+     */
+    class MappedWriter final {
+    public:
+        static constexpr std::size_t DEFAULT_WINDOW_SIZE = 64 * 1024 * 1024;
+
+        MappedWriter(int fd, std::size_t patternSize, bool syncWindows, std::size_t windowSize = DEFAULT_WINDOW_SIZE);
+        ~MappedWriter() = default;
+
+        /* pattern repeats without seams over windows of ranges, which are multiple of granularity */
+        std::size_t granularity() const { return granularity_; }
+
+        /* offsets of ranges must be multiple of page size */
+        std::size_t pageSize() const { return pageSize_; }
+
+        Result<std::uintmax_t, FileError> writeRange(const std::uint8_t* pattern, std::uintmax_t offset,
+                                                     std::uintmax_t length);
+
+    private:
+        void fillWindow(std::uint8_t* window, const std::uint8_t* pattern, std::size_t length) const;
+
+    private:
+        int fd;
+        std::size_t patternSize;
+        std::size_t pageSize_;
+        std::size_t granularity_;
+        std::size_t windowSize;
+        bool syncWindows;
+    };
+}
@@ -28,14 +28,18 @@
 namespace kl::fs {
 
     enum class OverwriteMode : std::uint8_t {
+        DISCARD_MODE = 0,
         SIMPLE_MODE  = 1,
         OPENBSD_MODE = 3,
-        DOD_MODE     = 7
+        DOD_MODE     = 7,
+        GUTMANN_MODE = 35
     };
 
-    inline constexpr util::enumeration::Enumeration<OverwriteMode, 3> OVERWRITE_MODE = {
+    inline constexpr util::enumeration::Enumeration<OverwriteMode, 5> OVERWRITE_MODE = {
+        {OverwriteMode::DISCARD_MODE, "DISCARD_MODE"},
         {OverwriteMode::SIMPLE_MODE, "SIMPLE_MODE"},
         {OverwriteMode::OPENBSD_MODE, "OPENBSD_MODE"},
-        {OverwriteMode::DOD_MODE, "DOD_MODE"}
+        {OverwriteMode::DOD_MODE, "DOD_MODE"},
+        {OverwriteMode::GUTMANN_MODE, "GUTMANN_MODE"}
     };
 }
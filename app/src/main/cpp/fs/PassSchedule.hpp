@@ -0,0 +1,158 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <utility>
+
+#include "OverwriteMode.hpp"
+
+namespace kl::fs {
+
+    enum class PassKind : std::uint8_t {
+        PATTERN_PASS = 1,
+        RANDOM_PASS = 2
+    };
+
+    /* pass writes repeated pattern of one or three bytes or fresh random data */
+    struct OverwritePass final {
+        PassKind kind;
+        std::uint8_t patternSize;
+        std::array<std::uint8_t, 3> pattern;
+
+        constexpr bool operator==(const OverwritePass&) const = default;
+    };
+
+    constexpr OverwritePass bytePass(std::uint8_t value) {
+        return {PassKind::PATTERN_PASS, 1, {value, value, value}};
+    }
+
+    constexpr OverwritePass patternPass(std::uint8_t first, std::uint8_t second, std::uint8_t third) {
+        return {PassKind::PATTERN_PASS, 3, {first, second, third}};
+    }
+
+    constexpr OverwritePass randomPass() {
+        return {PassKind::RANDOM_PASS, 0, {}};
+    }
+
+    inline constexpr std::array<OverwritePass, 1> SIMPLE_SCHEDULE = {
+        bytePass(0x00)
+    };
+
+    inline constexpr std::array<OverwritePass, 3> OPENBSD_SCHEDULE = {
+        bytePass(0xFF), bytePass(0x00), bytePass(0xFF)
+    };
+
+    /* DoD 5220.22-M ECE */
+    inline constexpr std::array<OverwritePass, 7> DOD_SCHEDULE = {
+        bytePass(0xF6), bytePass(0x00), bytePass(0xFF), randomPass(),
+        bytePass(0x00), bytePass(0xFF), randomPass()
+    };
+
+    /* Peter Gutmann, "Secure Deletion of Data from Magnetic and Solid-State Memory" */
+    inline constexpr std::array<OverwritePass, 35> GUTMANN_SCHEDULE = {
+        randomPass(), randomPass(), randomPass(), randomPass(),
+        bytePass(0x55), bytePass(0xAA),
+        patternPass(0x92, 0x49, 0x24), patternPass(0x49, 0x24, 0x92), patternPass(0x24, 0x92, 0x49),
+        bytePass(0x00), bytePass(0x11), bytePass(0x22), bytePass(0x33),
+        bytePass(0x44), bytePass(0x55), bytePass(0x66), bytePass(0x77),
+        bytePass(0x88), bytePass(0x99), bytePass(0xAA), bytePass(0xBB),
+        bytePass(0xCC), bytePass(0xDD), bytePass(0xEE), bytePass(0xFF),
+        patternPass(0x92, 0x49, 0x24), patternPass(0x49, 0x24, 0x92), patternPass(0x24, 0x92, 0x49),
+        patternPass(0x6D, 0xB6, 0xDB), patternPass(0xB6, 0xDB, 0x6D), patternPass(0xDB, 0x6D, 0xB6),
+        randomPass(), randomPass(), randomPass(), randomPass()
+    };
+
+    /* DISCARD_MODE has no passes, its optional pattern pass is SIMPLE_SCHEDULE */
+    inline constexpr std::array<std::pair<OverwriteMode, std::span<const OverwritePass>>, 4> PASS_SCHEDULES = {{
+        {OverwriteMode::SIMPLE_MODE, SIMPLE_SCHEDULE},
+        {OverwriteMode::OPENBSD_MODE, OPENBSD_SCHEDULE},
+        {OverwriteMode::DOD_MODE, DOD_SCHEDULE},
+        {OverwriteMode::GUTMANN_MODE, GUTMANN_SCHEDULE}
+    }};
+
+    constexpr std::span<const OverwritePass> passSchedule(OverwriteMode mode) {
+        for (const auto& [scheduleMode, schedule] : PASS_SCHEDULES) {
+            if (scheduleMode == mode) {
+                return schedule;
+            }
+        }
+
+        return {};
+    }
+
+    /* least common multiple of pattern sizes, writers restart pattern at every chunk */
+    constexpr std::size_t patternPeriod(std::span<const OverwritePass> schedule) {
+        std::size_t period = 1;
+
+        for (const auto& pass : schedule) {
+            if (pass.kind == PassKind::PATTERN_PASS) {
+                period = std::lcm<std::size_t>(period, pass.patternSize);
+            }
+        }
+
+        return period;
+    }
+
+    /* chunk multiple of period keeps phase of three byte patterns across chunks and slices */
+    constexpr std::size_t alignChunkSize(std::size_t chunkSize, std::size_t period, std::size_t alignment) {
+        const std::size_t granularity = std::lcm(period, alignment);
+        return (chunkSize + granularity - 1) / granularity * granularity;
+    }
+
+    inline void fillPattern(std::uint8_t* data, std::size_t size, const OverwritePass& pass) {
+        if (pass.patternSize == 1) {
+            std::memset(data, pass.pattern[0], size);
+            return;
+        }
+
+        const std::size_t head = std::min<std::size_t>(pass.patternSize, size);
+        std::memcpy(data, pass.pattern.data(), head);
+
+        /* double filled prefix, it always ends on whole pattern */
+        for (std::size_t filled = head; filled < size;) {
+            const std::size_t count = std::min(filled, size - filled);
+            std::memcpy(data + filled, data, count);
+            filled += count;
+        }
+    }
+
+    /* value of mode is count of its passes, Java side and benchmark rely on it */
+    constexpr bool hasValidPassCounts() {
+        for (const auto& [mode, schedule] : PASS_SCHEDULES) {
+            if (schedule.size() != static_cast<std::size_t>(mode)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(hasValidPassCounts());
+}
@@ -0,0 +1,206 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PassVerifier.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace kl::fs {
+    using Bytes = std::uint8_t __attribute__((vector_size(16)));
+
+    /* index of first different byte, or size when ranges are equal */
+    static std::size_t findMismatch(const std::uint8_t* data, const std::uint8_t* expected, std::size_t size) {
+        constexpr std::size_t STEP = 4 * sizeof(Bytes);
+        std::size_t i = 0;
+
+        for (; i + STEP <= size; i += STEP) {
+            Bytes left[4];
+            Bytes right[4];
+            std::memcpy(left, data + i, STEP);
+            std::memcpy(right, expected + i, STEP);
+
+            const Bytes diff = (left[0] ^ right[0]) | (left[1] ^ right[1]) |
+                               (left[2] ^ right[2]) | (left[3] ^ right[3]);
+            std::uint64_t words[2];
+            std::memcpy(words, &diff, sizeof(words));
+
+            if ((words[0] | words[1]) != 0) {
+                break;
+            }
+        }
+
+        for (; i < size; ++i) {
+            if (data[i] != expected[i]) {
+                return i;
+            }
+        }
+
+        return size;
+    }
+
+    PassVerifier::PassVerifier(BufferPool& pool)
+        : pool(pool)
+        , fd(-1)
+        , pattern(nullptr)
+        , patternSize(0)
+        , finished(true)
+        , countMismatches_(0) {
+    }
+
+    PassVerifier::~PassVerifier() {
+        stop();
+    }
+
+    void PassVerifier::start(int newFd, const std::uint8_t* newPattern, std::size_t newPatternSize) {
+        stop();
+
+        fd = newFd;
+        pattern = newPattern;
+        patternSize = newPatternSize;
+
+        finished = false;
+        error.reset();
+        mismatches_.clear();
+        countMismatches_ = 0;
+
+        if (!readBuffer || readBuffer.size() < patternSize) {
+            this->readBuffer = pool.acquire(patternSize);
+        }
+
+        worker = std::thread(&PassVerifier::run, this);
+    }
+
+    void PassVerifier::submit(std::uintmax_t offset, std::uintmax_t length) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ranges.push_back({offset, length});
+        }
+
+        condition.notify_one();
+    }
+
+    Result<void, FileError> PassVerifier::finish() {
+        stop();
+
+        if (error.has_value()) {
+            return *error;
+        }
+
+        return {};
+    }
+
+    void PassVerifier::cancel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ranges.clear();
+        }
+
+        stop();
+    }
+
+    void PassVerifier::stop() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished = true;
+            }
+
+            condition.notify_one();
+            worker.join();
+        }
+    }
+
+    void PassVerifier::run() {
+        while (true) {
+            FileExtent range = {};
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !ranges.empty() || finished; });
+
+                if (ranges.empty()) {
+                    return;
+                }
+
+                range = ranges.front();
+                ranges.pop_front();
+            }
+
+            if (auto result = verifyRange(range.offset, range.length); result.hasError()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = static_cast<FileError>(result.error());
+                ranges.clear();
+                return;
+            }
+        }
+    }
+
+    Result<void, FileError> PassVerifier::verifyRange(std::uintmax_t offset, std::uintmax_t length) {
+        ::sync_file_range(fd, static_cast<off_t>(offset), static_cast<off_t>(length),
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+
+        const std::uintmax_t end = offset + length;
+
+        while (offset < end) {
+            const auto size = static_cast<std::size_t>(std::min<std::uintmax_t>(patternSize, end - offset));
+            std::size_t done = 0;
+
+            while (done < size) {
+                const ssize_t count = ::pread(fd, readBuffer.get() + done, size - done,
+                                              static_cast<off_t>(offset + done));
+
+                if (count == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    return FileError("Fail read back file, error %s", ::strerror(errno));
+                }
+
+                if (count == 0) {
+                    return FileError("Fail read back file, unexpected end at %ju", offset + done);
+                }
+
+                done += static_cast<std::size_t>(count);
+            }
+
+            if (std::size_t index = findMismatch(readBuffer.get(), pattern, size); index != size) {
+                if (mismatches_.size() < MAX_REPORTED_MISMATCHES) {
+                    mismatches_.push_back(offset + index);
+                }
+
+                ++countMismatches_;
+            }
+
+            offset += size;
+        }
+
+        return {};
+    }
+}
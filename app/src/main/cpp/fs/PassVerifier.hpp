@@ -0,0 +1,93 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "BufferPool.hpp"
+#include "FileError.hpp"
+#include "FileUtil.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+
+    /*
+     * Reads back ranges of a pass on own thread, while writer goes on with next
+     * chunks. Each range is written back and dropped from page cache before read,
+     * so comparison sees data of the device, not of the cache.
+     */
+    class PassVerifier final {
+    public:
+        static constexpr std::size_t MAX_REPORTED_MISMATCHES = 16;
+
+        explicit PassVerifier(BufferPool& pool);
+        ~PassVerifier();
+
+        PassVerifier(const PassVerifier&) = delete;
+        PassVerifier& operator=(const PassVerifier&) = delete;
+
+        /* pattern must stay unchanged until finish */
+        void start(int fd, const std::uint8_t* pattern, std::size_t patternSize);
+        /* range is expected to repeat pattern from its offset */
+        void submit(std::uintmax_t offset, std::uintmax_t length);
+        Result<void, FileError> finish();
+        /* drop queued ranges and join worker, before fd or pattern go away */
+        void cancel();
+
+        /* first offsets of mismatched chunks, at most MAX_REPORTED_MISMATCHES */
+        const std::vector<std::uintmax_t>& mismatches() const { return mismatches_; }
+        std::uintmax_t countMismatches() const { return countMismatches_; }
+
+    private:
+        void stop();
+        void run();
+        Result<void, FileError> verifyRange(std::uintmax_t offset, std::uintmax_t length);
+
+    private:
+        BufferPool& pool;
+        PooledBuffer readBuffer;
+
+        int fd;
+        const std::uint8_t* pattern;
+        std::size_t patternSize;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<FileExtent> ranges;
+        bool finished;
+
+        std::optional<FileError> error;
+        std::vector<std::uintmax_t> mismatches_;
+        std::uintmax_t countMismatches_;
+    };
+}
@@ -0,0 +1,122 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "RangeWriter.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include <logging/Logging.hpp>
+
+namespace kl::fs {
+    static constexpr const char* TAG = "RangeWriter-JNI";
+
+    RangeWriter::RangeWriter(int fd, std::size_t countThreads)
+        : fd(fd)
+        , countThreads_(std::max<std::size_t>(countThreads, 1)) {
+    }
+
+    Result<std::uintmax_t, FileError> RangeWriter::writeExtents(const std::uint8_t* pattern, std::size_t patternSize,
+                                                                const std::vector<FileExtent>& extents,
+                                                                const Completion& complete) {
+        /* every range starts at the beginning of pattern, as a sequential write of its extent */
+        const std::size_t granularity = std::lcm<std::size_t>(patternSize, ::sysconf(_SC_PAGESIZE));
+        const std::uintmax_t rangeSize = (RANGE_SIZE + granularity - 1) / granularity * granularity;
+        std::vector<FileExtent> ranges;
+
+        for (const auto& [offset, length] : extents) {
+            for (std::uintmax_t begin = 0; begin < length; begin += rangeSize) {
+                ranges.push_back({offset + begin, std::min(rangeSize, length - begin)});
+            }
+        }
+
+        std::atomic<std::size_t> nextRange = 0;
+        std::atomic<std::uintmax_t> written = 0;
+        std::atomic<bool> failed = false;
+        std::optional<FileError> error;
+        std::mutex errorMutex;
+
+        auto failWith = [&](FileError&& newError) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+
+            if (!error.has_value()) {
+                error = std::move(newError);
+            }
+
+            failed.store(true, std::memory_order_relaxed);
+        };
+
+        auto worker = [&] {
+            while (!failed.load(std::memory_order_relaxed)) {
+                const std::size_t index = nextRange.fetch_add(1, std::memory_order_relaxed);
+
+                if (index >= ranges.size()) {
+                    break;
+                }
+
+                const auto& [offset, length] = ranges[index];
+
+                if (auto result = writePattern(fd, pattern, patternSize, offset, length); result.hasValue()) {
+                    written.fetch_add(result.value(), std::memory_order_relaxed);
+                } else {
+                    failWith(static_cast<FileError>(result.error()));
+                    break;
+                }
+
+                if (auto result = complete(offset, length); result.hasError()) {
+                    failWith(static_cast<FileError>(result.error()));
+                    break;
+                }
+            }
+        };
+
+        const std::size_t countWorkers = std::min(countThreads_, ranges.size());
+        std::vector<std::thread> threads;
+        threads.reserve(countWorkers > 0 ? countWorkers - 1 : 0);
+
+        /* calling thread is one of writers */
+        for (std::size_t i = 1; i < countWorkers; ++i) {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (error.has_value()) {
+            return std::move(*error);
+        }
+
+        log::debug(TAG, "Write %zu ranges with %zu threads", ranges.size(), countWorkers);
+
+        return written.load();
+    }
+}
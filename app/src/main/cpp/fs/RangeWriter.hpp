@@ -0,0 +1,70 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "FileError.hpp"
+#include "FileUnit.hpp"
+#include "FileUtil.hpp"
+
+#include <util/error/Result.hpp>
+
+namespace kl::fs {
+    using namespace kl::util::error;
+    using fs::literals::operator""_mb;
+
+    /*
+     * Overwrite one large file from several threads. Extents are cut into ranges
+     * aligned to the pattern, threads take next range and write it with pwrite.
+     * A pass returns only when every range is written, so passes never overlap
+     * and each range sees them in order.
+     */
+    class RangeWriter final {
+    public:
+        static constexpr std::uintmax_t RANGE_SIZE = 16_mb;
+
+        /* called from writer threads for each written range, error stops the pass */
+        using Completion = std::function<Result<void, FileError>(std::uintmax_t offset, std::uintmax_t length)>;
+
+        RangeWriter(int fd, std::size_t countThreads);
+        ~RangeWriter() = default;
+
+        RangeWriter(const RangeWriter&) = delete;
+        RangeWriter& operator=(const RangeWriter&) = delete;
+
+        std::size_t countThreads() const { return countThreads_; }
+
+        /* pattern is shared by all threads and must stay unchanged until return */
+        Result<std::uintmax_t, FileError> writeExtents(const std::uint8_t* pattern, std::size_t patternSize,
+                                                       const std::vector<FileExtent>& extents,
+                                                       const Completion& complete);
+
+    private:
+        int fd;
+        std::size_t countThreads_;
+    };
+}
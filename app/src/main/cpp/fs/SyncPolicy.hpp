@@ -0,0 +1,47 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <util/enumeration/Enumeration.hpp>
+
+namespace kl::fs {
+
+    /*
+     * When overwritten data is forced to the device. Without sync dirty pages
+     * of a file could be dropped by truncate before they are ever written back.
+     */
+    enum class SyncPolicy : std::uint8_t {
+        NO_SYNC = 1,    /* leave writeback to kernel */
+        PASS_SYNC = 2,  /* fdatasync after every pass */
+        FILE_SYNC = 3,  /* fdatasync once after last pass */
+        BATCH_SYNC = 4  /* syncfs for a batch of files, then truncate and remove them */
+    };
+
+    inline constexpr util::enumeration::Enumeration<SyncPolicy, 4> SYNC_POLICY = {
+        {SyncPolicy::NO_SYNC, "NO_SYNC"},
+        {SyncPolicy::PASS_SYNC, "PASS_SYNC"},
+        {SyncPolicy::FILE_SYNC, "FILE_SYNC"},
+        {SyncPolicy::BATCH_SYNC, "BATCH_SYNC"}
+    };
+}
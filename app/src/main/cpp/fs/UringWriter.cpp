@@ -0,0 +1,318 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "UringWriter.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace kl::fs {
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+    static int uringSetup(std::uint32_t entries, io_uring_params* params) {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    static int uringEnter(int fd, std::uint32_t toSubmit, std::uint32_t minComplete, std::uint32_t flags) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    static int uringRegister(int fd, std::uint32_t opcode, const void* arguments, std::uint32_t count) {
+        return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arguments, count));
+    }
+#else
+    static int uringSetup(std::uint32_t, io_uring_params*) { errno = ENOSYS; return -1; }
+    static int uringEnter(int, std::uint32_t, std::uint32_t, std::uint32_t) { errno = ENOSYS; return -1; }
+    static int uringRegister(int, std::uint32_t, const void*, std::uint32_t) { errno = ENOSYS; return -1; }
+#endif
+
+    template<typename T>
+    static T* ringPointer(void* ring, std::uint32_t offset) {
+        return reinterpret_cast<T*>(static_cast<std::uint8_t*>(ring) + offset);
+    }
+
+    UringWriter::UringWriter()
+        : ringFd(-1)
+        , queueDepth(0)
+        , sqRing(MAP_FAILED), sqRingSize(0)
+        , cqRing(MAP_FAILED), cqRingSize(0)
+        , sqes(nullptr), sqesSize(0)
+        , sqTail(nullptr), sqMask(nullptr), sqArray(nullptr)
+        , cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqes(nullptr)
+        , buffer(nullptr)
+        , fileRegistered(false)
+        , bufferRegistered(false) {
+    }
+
+    UringWriter::~UringWriter() {
+        unregister();
+
+        if (sqes != nullptr) {
+            ::munmap(sqes, sqesSize);
+        }
+
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            ::munmap(cqRing, cqRingSize);
+        }
+
+        if (sqRing != MAP_FAILED) {
+            ::munmap(sqRing, sqRingSize);
+        }
+
+        if (ringFd != -1) {
+            ::close(ringFd);
+        }
+    }
+
+    Result<std::unique_ptr<UringWriter>, FileError> UringWriter::create(std::uint32_t queueDepth) {
+        std::unique_ptr<UringWriter> writer(new UringWriter());
+        io_uring_params params = {};
+
+        writer->ringFd = uringSetup(queueDepth, &params);
+
+        if (writer->ringFd < 0) {
+            return FileError("Can't setup io_uring, error %s", ::strerror(errno));
+        }
+
+        writer->queueDepth = params.sq_entries;
+        writer->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+        writer->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        writer->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (singleMap) {
+            writer->sqRingSize = writer->cqRingSize = std::max(writer->sqRingSize, writer->cqRingSize);
+        }
+
+        writer->sqRing = ::mmap(nullptr, writer->sqRingSize, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, writer->ringFd, IORING_OFF_SQ_RING);
+
+        if (writer->sqRing == MAP_FAILED) {
+            return FileError("Can't map io_uring submission ring, error %s", ::strerror(errno));
+        }
+
+        if (singleMap) {
+            writer->cqRing = writer->sqRing;
+        } else {
+            writer->cqRing = ::mmap(nullptr, writer->cqRingSize, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_POPULATE, writer->ringFd, IORING_OFF_CQ_RING);
+
+            if (writer->cqRing == MAP_FAILED) {
+                return FileError("Can't map io_uring completion ring, error %s", ::strerror(errno));
+            }
+        }
+
+        void* sqes = ::mmap(nullptr, writer->sqesSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, writer->ringFd, IORING_OFF_SQES);
+
+        if (sqes == MAP_FAILED) {
+            return FileError("Can't map io_uring submission entries, error %s", ::strerror(errno));
+        }
+
+        writer->sqes = static_cast<io_uring_sqe*>(sqes);
+
+        writer->sqTail = ringPointer<std::uint32_t>(writer->sqRing, params.sq_off.tail);
+        writer->sqMask = ringPointer<std::uint32_t>(writer->sqRing, params.sq_off.ring_mask);
+        writer->sqArray = ringPointer<std::uint32_t>(writer->sqRing, params.sq_off.array);
+        writer->cqHead = ringPointer<std::uint32_t>(writer->cqRing, params.cq_off.head);
+        writer->cqTail = ringPointer<std::uint32_t>(writer->cqRing, params.cq_off.tail);
+        writer->cqMask = ringPointer<std::uint32_t>(writer->cqRing, params.cq_off.ring_mask);
+        writer->cqes = ringPointer<io_uring_cqe>(writer->cqRing, params.cq_off.cqes);
+
+        return writer;
+    }
+
+    Result<void, FileError> UringWriter::registerFile(int fd) {
+        if (uringRegister(ringFd, IORING_REGISTER_FILES, &fd, 1) < 0) {
+            return FileError("Can't register file in io_uring, error %s", ::strerror(errno));
+        }
+
+        fileRegistered = true;
+
+        return {};
+    }
+
+    Result<void, FileError> UringWriter::registerBuffer(std::uint8_t* data, std::size_t size) {
+        iovec vector = { .iov_base = data, .iov_len = size };
+
+        if (uringRegister(ringFd, IORING_REGISTER_BUFFERS, &vector, 1) < 0) {
+            return FileError("Can't register buffer in io_uring, error %s", ::strerror(errno));
+        }
+
+        buffer = data;
+        bufferRegistered = true;
+
+        return {};
+    }
+
+    void UringWriter::unregister() {
+        if (bufferRegistered) {
+            uringRegister(ringFd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            bufferRegistered = false;
+            buffer = nullptr;
+        }
+
+        if (fileRegistered) {
+            uringRegister(ringFd, IORING_UNREGISTER_FILES, nullptr, 0);
+            fileRegistered = false;
+        }
+    }
+
+    Result<std::uintmax_t, FileError> UringWriter::writeRange(std::uintmax_t offset, std::uintmax_t length,
+                                                              std::size_t chunkSize) {
+        const std::uintmax_t end = offset + length;
+        std::uintmax_t written = 0;
+        std::uint32_t inFlight = 0;
+
+        if (!fileRegistered || !bufferRegistered) {
+            return FileError("File and buffer must be registered in io_uring");
+        }
+
+        /* prepared entries, which kernel hasn't consumed yet, they stay counted in flight */
+        std::uint32_t pending = 0;
+
+        while (offset < end || inFlight > 0) {
+            while (inFlight < queueDepth && offset < end) {
+                const auto size = static_cast<std::uint32_t>(std::min<std::uintmax_t>(chunkSize, end - offset));
+
+                submit(offset, size);
+
+                offset += size;
+                ++inFlight;
+                ++pending;
+            }
+
+            /* wait only when some write is already in kernel, otherwise enter could block forever */
+            const std::uint32_t submitted = inFlight - pending;
+            const int count = uringEnter(ringFd, pending, submitted > 0 ? 1 : 0, IORING_ENTER_GETEVENTS);
+
+            if (count < 0) {
+                /* EAGAIN and EBUSY are transient while completions of submitted writes are due */
+                if (errno == EINTR || ((errno == EAGAIN || errno == EBUSY) && submitted > 0)) {
+                    if (auto result = reap(inFlight); result.hasValue()) {
+                        written += result.value();
+                        continue;
+                    } else {
+                        discard(pending, inFlight);
+                        drain(inFlight);
+                        return static_cast<FileError>(result.error());
+                    }
+                }
+
+                const int error = errno;
+                discard(pending, inFlight);
+                drain(inFlight);
+                return FileError("Can't enter io_uring, error %s", ::strerror(error));
+            }
+
+            pending -= static_cast<std::uint32_t>(count);
+
+            if (count == 0 && pending > 0 && submitted == 0) {
+                discard(pending, inFlight);
+                return FileError("io_uring didn't accept any write");
+            }
+
+            if (auto result = reap(inFlight); result.hasValue()) {
+                written += result.value();
+            } else {
+                discard(pending, inFlight);
+                drain(inFlight);
+                return static_cast<FileError>(result.error());
+            }
+        }
+
+        return written;
+    }
+
+    void UringWriter::submit(std::uintmax_t offset, std::uint32_t length) {
+        const std::uint32_t tail = *sqTail;
+        const std::uint32_t index = tail & *sqMask;
+        io_uring_sqe* entry = &sqes[index];
+
+        std::memset(entry, 0, sizeof(io_uring_sqe));
+        entry->opcode = IORING_OP_WRITE_FIXED;
+        entry->flags = IOSQE_FIXED_FILE;
+        entry->fd = 0; /* index in registered files */
+        entry->addr = reinterpret_cast<std::uintptr_t>(buffer);
+        entry->len = length;
+        entry->off = offset;
+        entry->buf_index = 0;
+        entry->user_data = length;
+
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    /* withdraw entries, which kernel hasn't consumed, so next writes don't submit them */
+    void UringWriter::discard(std::uint32_t& pending, std::uint32_t& inFlight) {
+        __atomic_store_n(sqTail, *sqTail - pending, __ATOMIC_RELEASE);
+        inFlight -= pending;
+        pending = 0;
+    }
+
+    Result<std::uintmax_t, FileError> UringWriter::reap(std::uint32_t& inFlight) {
+        std::uint32_t head = *cqHead;
+        const std::uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        std::uintmax_t written = 0;
+        int error = 0;
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe& completion = cqes[head & *cqMask];
+            --inFlight;
+
+            if (completion.res < 0) {
+                error = -completion.res;
+            } else if (static_cast<std::uint64_t>(completion.res) != completion.user_data) {
+                error = EIO;
+            } else {
+                written += static_cast<std::uintmax_t>(completion.res);
+            }
+        }
+
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        if (error != 0) {
+            return FileError("Fail io_uring write to file, error %s", ::strerror(error));
+        }
+
+        return written;
+    }
+
+    void UringWriter::drain(std::uint32_t& inFlight) {
+        while (inFlight > 0) {
+            if (uringEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                break;
+            }
+
+            [[maybe_unused]] auto result = reap(inFlight);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "FileError.hpp"
+
+#include <util/error/Result.hpp>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace kl::fs {
+    using namespace kl::util::error;
+
+    /*
+     * Minimal io_uring ring over raw syscalls (NDK has no liburing).
+     * Keeps up to queue depth fixed-buffer writes of one registered
+     * file in flight, all of them sourced from one registered buffer.
+     */
+    class UringWriter final {
+    public:
+        ~UringWriter();
+
+        UringWriter(const UringWriter&) = delete;
+        UringWriter& operator=(const UringWriter&) = delete;
+
+        /* error when kernel or seccomp/selinux policy doesn't allow io_uring */
+        static Result<std::unique_ptr<UringWriter>, FileError> create(std::uint32_t queueDepth);
+
+        Result<void, FileError> registerFile(int fd);
+        Result<void, FileError> registerBuffer(std::uint8_t* data, std::size_t size);
+        void unregister();
+
+        /* overwrite [offset, offset + length) by chunks of registered buffer */
+        Result<std::uintmax_t, FileError> writeRange(std::uintmax_t offset, std::uintmax_t length,
+                                                     std::size_t chunkSize);
+
+    private:
+        UringWriter();
+
+        void submit(std::uintmax_t offset, std::uint32_t length);
+        void discard(std::uint32_t& pending, std::uint32_t& inFlight);
+        Result<std::uintmax_t, FileError> reap(std::uint32_t& inFlight);
+        void drain(std::uint32_t& inFlight);
+
+    private:
+        int ringFd;
+        std::uint32_t queueDepth;
+
+        void* sqRing;
+        std::size_t sqRingSize;
+        void* cqRing;
+        std::size_t cqRingSize;
+        io_uring_sqe* sqes;
+        std::size_t sqesSize;
+
+        std::uint32_t* sqTail;
+        std::uint32_t* sqMask;
+        std::uint32_t* sqArray;
+        std::uint32_t* cqHead;
+        std::uint32_t* cqTail;
+        std::uint32_t* cqMask;
+        io_uring_cqe* cqes;
+
+        std::uint8_t* buffer;
+        bool fileRegistered;
+        bool bufferRegistered;
+    };
+}
@@ -0,0 +1,45 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <util/enumeration/Enumeration.hpp>
+
+namespace kl::fs {
+
+    enum class WriteBackend : std::uint8_t {
+        STDIO_BACKEND = 1,
+        URING_BACKEND = 2,
+        DIRECT_BACKEND = 3,
+        MMAP_BACKEND = 4,
+        AUTO_BACKEND = 5
+    };
+
+    inline constexpr util::enumeration::Enumeration<WriteBackend, 5> WRITE_BACKEND = {
+        {WriteBackend::STDIO_BACKEND, "STDIO_BACKEND"},
+        {WriteBackend::URING_BACKEND, "URING_BACKEND"},
+        {WriteBackend::DIRECT_BACKEND, "DIRECT_BACKEND"},
+        {WriteBackend::MMAP_BACKEND, "MMAP_BACKEND"},
+        {WriteBackend::AUTO_BACKEND, "AUTO_BACKEND"}
+    };
+}
@@ -29,13 +29,15 @@ extern JavaVM* globalJavaVm;
 namespace kl::jni {
     static constexpr jint JNI_DEFAULT_VERSION = JNI_VERSION_1_6;
 
-    UniqueJniEnv::UniqueJniEnv() : env(nullptr), attached(false) {
+    UniqueJniEnv::UniqueJniEnv() : UniqueJniEnv(nullptr) {}
+
+    UniqueJniEnv::UniqueJniEnv(const char* threadName) : env(nullptr), attached(false) {
         if (!globalJavaVm) return;
 
         jint status = globalJavaVm->GetEnv((void**)&env, JNI_DEFAULT_VERSION);
 
         if (status != JNI_OK) {
-            JavaVMAttachArgs args = {JNI_DEFAULT_VERSION, nullptr, nullptr};
+            JavaVMAttachArgs args = {JNI_DEFAULT_VERSION, const_cast<char*>(threadName), nullptr};
 
             if (globalJavaVm->AttachCurrentThread(&env, &args) == JNI_OK) {
                 attached = true;
@@ -52,6 +54,8 @@ namespace kl::jni {
     void UniqueJniEnv::release() {
         if (attached && globalJavaVm) {
             globalJavaVm->DetachCurrentThread();
+            attached = false;
+            env = nullptr;
         }
     }
 }
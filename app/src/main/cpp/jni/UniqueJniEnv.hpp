@@ -31,6 +31,8 @@ namespace kl::jni {
     class UniqueJniEnv final {
     public:
         UniqueJniEnv();
+        /* name is shown by JVM for thread, which is attached here */
+        explicit UniqueJniEnv(const char* threadName);
         ~UniqueJniEnv();
 
         void release();
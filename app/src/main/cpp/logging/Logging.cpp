@@ -24,9 +24,16 @@
 
 #include "Logging.hpp"
 
+#if defined(__ANDROID__)
 #include <android/log.h>
+#else
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#endif
 
 namespace kl::log {
+#if defined(__ANDROID__)
 
     void info(const char* tag, const char* format, ...) {
         va_list arguments;
@@ -58,7 +65,58 @@ namespace kl::log {
     }
 
     void error(const char* tag, const std::string& message) {
-        __android_log_write(ANDROID_LOG_DEBUG, tag, message.c_str());
+        __android_log_write(ANDROID_LOG_ERROR, tag, message.c_str());
+    }
+#else
+    /* host builds (benchmarks) write to stderr, debug only with FIREARROW_DEBUG set */
+    static bool isDebugEnabled() {
+        static const bool enabled = std::getenv("FIREARROW_DEBUG") != nullptr;
+        return enabled;
+    }
+
+    static void write(char level, const char* tag, const char* format, va_list arguments) {
+        std::fprintf(stderr, "%c/%s: ", level, tag);
+        std::vfprintf(stderr, format, arguments);
+        std::fputc('\n', stderr);
     }
-}
 
+    void info(const char* tag, const char* format, ...) {
+        va_list arguments;
+        va_start(arguments, format);
+        write('I', tag, format, arguments);
+        va_end(arguments);
+    }
+
+    void info(const char* tag, const std::string& message) {
+        std::fprintf(stderr, "I/%s: %s\n", tag, message.c_str());
+    }
+
+    void debug(const char* tag, const char* format, ...) {
+        if (!isDebugEnabled()) {
+            return;
+        }
+
+        va_list arguments;
+        va_start(arguments, format);
+        write('D', tag, format, arguments);
+        va_end(arguments);
+    }
+
+    void debug(const char* tag, const std::string& message) {
+        if (isDebugEnabled()) {
+            std::fprintf(stderr, "D/%s: %s\n", tag, message.c_str());
+        }
+    }
+
+    void error(const char* tag, const char* format, ...) {
+        va_list arguments;
+        va_start(arguments, format);
+        write('E', tag, format, arguments);
+        va_end(arguments);
+    }
+
+    void error(const char* tag, const std::string& message) {
+        std::fprintf(stderr, "E/%s: %s\n", tag, message.c_str());
+    }
+#endif
+}
@@ -33,20 +33,20 @@ namespace kl::net {
     using namespace kl::util::property;
 
     class NetworkError final {
+    private:
+        /* declared before getter, which binds to it */
+        std::string message_;
+
     public:
-        explicit NetworkError(const std::string& text) : message(message_), message_(text) {}
-        explicit NetworkError(std::string&& text) : message(message_), message_(std::move(text)) {}
+        explicit NetworkError(const std::string& text) : message_(text), message(message_) {}
+        explicit NetworkError(std::string&& text) : message_(std::move(text)), message(message_) {}
 
         template<typename... Args>
-        explicit NetworkError(const char* formatter, Args&&... arguments) : message(message_) {
-            message_ = format(formatter, std::forward<Args>(arguments)...);
-        }
+        explicit NetworkError(const char* formatter, Args&&... arguments)
+            : message_(format(formatter, std::forward<Args>(arguments)...)), message(message_) {}
 
         ~NetworkError() = default;
 
         Getter<std::string&> message;
-
-    private:
-        std::string message_;
     };
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <string>
 #include <optional>
 
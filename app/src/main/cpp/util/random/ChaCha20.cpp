@@ -0,0 +1,164 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ChaCha20.hpp"
+
+#include <bit>
+#include <cstring>
+#include <random>
+
+namespace kl::util::random {
+    static_assert(std::endian::native == std::endian::little, "ChaCha20 keystream is stored as little endian");
+
+    using Vector = std::uint32_t __attribute__((vector_size(16)));
+
+    static constexpr std::size_t LANES = sizeof(Vector) / sizeof(std::uint32_t);
+    static constexpr std::size_t WIDE_BLOCK_SIZE = LANES * ChaCha20::BLOCK_SIZE;
+
+    static inline std::uint32_t load32(const std::uint8_t* data) {
+        std::uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static inline Vector rotate(Vector value, int count) {
+        return (value << count) | (value >> (32 - count));
+    }
+
+    static inline void quarterRound(Vector& a, Vector& b, Vector& c, Vector& d) {
+        a += b; d ^= a; d = rotate(d, 16);
+        c += d; b ^= c; b = rotate(b, 12);
+        a += b; d ^= a; d = rotate(d, 8);
+        c += d; b ^= c; b = rotate(b, 7);
+    }
+
+    ChaCha20::ChaCha20(const std::array<std::uint8_t, KEY_SIZE>& key,
+                       const std::array<std::uint8_t, NONCE_SIZE>& nonce, std::uint32_t counter) {
+        state[0] = 0x61707865;
+        state[1] = 0x3320646e;
+        state[2] = 0x79622d32;
+        state[3] = 0x6b206574;
+
+        for (std::size_t i = 0; i < 8; ++i) {
+            state[4 + i] = load32(key.data() + 4 * i);
+        }
+
+        state[12] = counter;
+
+        for (std::size_t i = 0; i < 3; ++i) {
+            state[13 + i] = load32(nonce.data() + 4 * i);
+        }
+    }
+
+    ChaCha20 ChaCha20::fromEntropy() {
+        std::random_device device;
+        std::array<std::uint8_t, KEY_SIZE> key = {};
+        std::array<std::uint8_t, NONCE_SIZE> nonce = {};
+
+        for (std::size_t i = 0; i < KEY_SIZE; i += sizeof(std::uint32_t)) {
+            const std::uint32_t value = device();
+            std::memcpy(key.data() + i, &value, sizeof(value));
+        }
+
+        for (std::size_t i = 0; i < NONCE_SIZE; i += sizeof(std::uint32_t)) {
+            const std::uint32_t value = device();
+            std::memcpy(nonce.data() + i, &value, sizeof(value));
+        }
+
+        return ChaCha20(key, nonce);
+    }
+
+    void ChaCha20::fill(std::uint8_t* data, std::size_t size) {
+        while (size >= WIDE_BLOCK_SIZE) {
+            generateBlocks(data);
+            data += WIDE_BLOCK_SIZE;
+            size -= WIDE_BLOCK_SIZE;
+        }
+
+        if (size > 0) {
+            alignas(Vector) std::uint8_t tail[WIDE_BLOCK_SIZE];
+            generateBlocks(tail);
+            std::memcpy(data, tail, size);
+        }
+    }
+
+    void ChaCha20::generateBlocks(std::uint8_t* output) {
+        Vector input[16];
+        Vector x[16];
+
+        for (std::size_t i = 0; i < 16; ++i) {
+            input[i] = Vector{state[i], state[i], state[i], state[i]};
+        }
+
+        /* one block per lane, lane past counter wrap carries into nonce the same way as advance() */
+        for (std::uint32_t lane = 0; lane < LANES; ++lane) {
+            const std::uint32_t counter = state[12] + lane;
+            input[12][lane] = counter;
+
+            for (std::size_t i = 13, carry = counter < state[12]; i < 16 && carry != 0; ++i) {
+                input[i][lane] = state[i] + 1;
+                carry = input[i][lane] == 0;
+            }
+        }
+
+        std::memcpy(x, input, sizeof(x));
+
+        for (int round = 0; round < 10; ++round) {
+            quarterRound(x[0], x[4], x[8], x[12]);
+            quarterRound(x[1], x[5], x[9], x[13]);
+            quarterRound(x[2], x[6], x[10], x[14]);
+            quarterRound(x[3], x[7], x[11], x[15]);
+
+            quarterRound(x[0], x[5], x[10], x[15]);
+            quarterRound(x[1], x[6], x[11], x[12]);
+            quarterRound(x[2], x[7], x[8], x[13]);
+            quarterRound(x[3], x[4], x[9], x[14]);
+        }
+
+        for (std::size_t i = 0; i < 16; ++i) {
+            x[i] += input[i];
+        }
+
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+            for (std::size_t i = 0; i < 16; ++i) {
+                const std::uint32_t word = x[i][lane];
+                std::memcpy(output + lane * BLOCK_SIZE + i * sizeof(word), &word, sizeof(word));
+            }
+        }
+
+        advance(LANES);
+    }
+
+    void ChaCha20::advance(std::uint32_t count) {
+        const std::uint32_t counter = state[12];
+        state[12] = counter + count;
+
+        /* counter wrapped: move to the next nonce, so keystream never repeats */
+        if (state[12] < counter) {
+            if (++state[13] == 0 && ++state[14] == 0) {
+                ++state[15];
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace kl::util::random {
+
+    /*
+     * ChaCha20 keystream (RFC 8439 layout) used as bulk CSPRNG.
+     * Four blocks are computed at once in 128-bit vector lanes.
+     * Instance isn't thread safe, keep one per thread or session.
+     */
+    class ChaCha20 final {
+    public:
+        static constexpr std::size_t KEY_SIZE = 32;
+        static constexpr std::size_t NONCE_SIZE = 12;
+        static constexpr std::size_t BLOCK_SIZE = 64;
+
+        ChaCha20(const std::array<std::uint8_t, KEY_SIZE>& key,
+                 const std::array<std::uint8_t, NONCE_SIZE>& nonce, std::uint32_t counter = 0);
+        ~ChaCha20() = default;
+
+        /* seeded from kernel entropy */
+        static ChaCha20 fromEntropy();
+
+        void fill(std::uint8_t* data, std::size_t size);
+
+    private:
+        void generateBlocks(std::uint8_t* output);
+        void advance(std::uint32_t count);
+
+    private:
+        std::array<std::uint32_t, 16> state;
+    };
+}
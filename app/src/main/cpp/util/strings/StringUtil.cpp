@@ -32,11 +32,11 @@ namespace kl::util::strings {
     static constexpr char CHARACTERS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
 
     std::string randomBuffer(std::size_t length) {
-        std::random_device randomDevice;
-        std::mt19937 generator(randomDevice());
-        std::uniform_int_distribution<> distribution(0, std::ssize(CHARACTERS) - 1);
+        thread_local std::mt19937 generator(std::random_device{}());
+        std::uniform_int_distribution<> distribution(0, std::ssize(CHARACTERS) - 2);
 
         std::string result;
+        result.reserve(length);
 
         for (std::size_t i = 0; i < length; ++i) {
             result += CHARACTERS[distribution(generator)];
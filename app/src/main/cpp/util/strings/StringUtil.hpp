@@ -23,6 +23,8 @@
  */
 #pragma once
 
+#include <cstdio>
+#include <memory>
 #include <string>
 
 namespace kl::util::strings {
@@ -33,7 +35,7 @@ namespace kl::util::strings {
 
     template<typename... Args>
     std::string format(const char* formatter, Args... arguments) {
-        int formatterSize = std::sprintf(nullptr, 0, formatter, arguments...) + 1; // extra for '\0'
+        int formatterSize = std::snprintf(nullptr, 0, formatter, arguments...) + 1; // extra for '\0'
         if (formatterSize <= 0) return "";
 
         std::size_t size = static_cast<std::size_t>(formatterSize);
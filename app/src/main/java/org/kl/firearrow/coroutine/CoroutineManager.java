@@ -25,6 +25,9 @@ package org.kl.firearrow.coroutine;
 
 import androidx.annotation.NonNull;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.ReadOnlyBufferException;
 import java.util.Arrays;
 import java.util.concurrent.Callable;
 import java.util.concurrent.ExecutionException;
@@ -42,10 +45,38 @@ public final class CoroutineManager {
 
     public static native Task<Void> await(@NonNull Runnable runnable) throws CoroutineException;
     public static native <T> Task<T> await(@NonNull Callable<T> caller) throws CoroutineException;
+    /* runnables are run in parallel on native worker threads */
+    public static native Task<Void> awaitAll(@NonNull Runnable... runnables) throws CoroutineException;
 
     public static native <T extends Number> Generator<T> yield(T initValue, int count) throws CoroutineException;
     public static native <T extends Number> Generator<T> yield(T initValue, int begin, int end) throws CoroutineException;
 
+    /* numbers without boxing, they are copied by chunks */
+    public static native int[] yieldInts(int initValue, int begin, int end) throws CoroutineException;
+    public static native long[] yieldLongs(long initValue, int begin, int end) throws CoroutineException;
+
+    /*
+     * ints are written to direct buffer from its position up to its limit, buffer
+     * must have native byte order, position moves past them, count of them is returned
+     */
+    public static int yieldInto(int initValue, int begin, int end, @NonNull ByteBuffer buffer) throws CoroutineException {
+        if (buffer.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+
+        if (buffer.order() != ByteOrder.nativeOrder()) {
+            throw new IllegalArgumentException("Buffer must have native byte order");
+        }
+
+        final int count = yieldInto(initValue, begin, end, buffer, buffer.position(), buffer.remaining());
+        buffer.position(buffer.position() + count * Integer.BYTES);
+
+        return count;
+    }
+
+    private static native int yieldInto(int initValue, int begin, int end, @NonNull ByteBuffer buffer,
+                                        int position, int remaining) throws CoroutineException;
+
     public static String javaThreadRunnableOperation() {
         final long beginTime = System.currentTimeMillis();
         final var builder = new StringBuilder();
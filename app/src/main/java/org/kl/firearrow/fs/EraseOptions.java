@@ -0,0 +1,83 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022-2023 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.kl.firearrow.fs;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+
+import java.util.Objects;
+
+public record EraseOptions (
+    WriteBackend backend,
+    int queueDepth,
+    long mmapThreshold,
+    boolean patternPass,
+    boolean verify,
+    @Nullable EraseProgress progress,
+    SyncPolicy syncPolicy,
+    int syncBatchSize,
+    int rangeThreads,
+    long rangeThreshold,
+    boolean resumable,
+    boolean telemetry,
+    boolean tuneChunks
+) {
+    public static final int DEFAULT_QUEUE_DEPTH = 32;
+    public static final long DEFAULT_MMAP_THRESHOLD = 64L * 1024 * 1024;
+    public static final int DEFAULT_SYNC_BATCH_SIZE = 32;
+    public static final int DEFAULT_RANGE_THREADS = 1;
+    public static final long DEFAULT_RANGE_THRESHOLD = 256L * 1024 * 1024;
+
+    public EraseOptions {
+        Objects.requireNonNull(backend, "Field backend can't be null");
+        Objects.requireNonNull(syncPolicy, "Field syncPolicy can't be null");
+
+        if (queueDepth <= 0) {
+            throw new IllegalArgumentException("Queue depth must be positive: " + queueDepth);
+        }
+
+        if (mmapThreshold < 0) {
+            throw new IllegalArgumentException("Mmap threshold can't be negative: " + mmapThreshold);
+        }
+
+        if (syncBatchSize <= 0) {
+            throw new IllegalArgumentException("Sync batch size must be positive: " + syncBatchSize);
+        }
+
+        if (rangeThreads <= 0) {
+            throw new IllegalArgumentException("Range threads must be positive: " + rangeThreads);
+        }
+
+        if (rangeThreshold < 0) {
+            throw new IllegalArgumentException("Range threshold can't be negative: " + rangeThreshold);
+        }
+    }
+
+    @NonNull
+    public static EraseOptions defaults() {
+        return new EraseOptions(WriteBackend.STDIO_BACKEND, DEFAULT_QUEUE_DEPTH, DEFAULT_MMAP_THRESHOLD, false, false, null,
+                                SyncPolicy.FILE_SYNC, DEFAULT_SYNC_BATCH_SIZE, DEFAULT_RANGE_THREADS, DEFAULT_RANGE_THRESHOLD,
+                                false, false, false);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022-2023 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.kl.firearrow.fs;
+
+/**
+ * Native counters of running erase, which could be polled from any thread.
+ * Running erase keeps native counters alive, even if it is closed meanwhile,
+ * but methods of closed progress throw IllegalStateException.
+ */
+public final class EraseProgress implements AutoCloseable {
+    private long handle;
+
+    public EraseProgress() {
+        this.handle = create();
+    }
+
+    public synchronized long countBytes() {
+        return countBytes(checkHandle());
+    }
+
+    public synchronized long countFiles() {
+        return countFiles(checkHandle());
+    }
+
+    public synchronized int pass() {
+        return pass(checkHandle());
+    }
+
+    public synchronized void cancel() {
+        cancel(checkHandle());
+    }
+
+    public synchronized boolean isCancelled() {
+        return isCancelled(checkHandle());
+    }
+
+    @Override
+    public synchronized void close() {
+        if (handle != 0) {
+            destroy(handle);
+            handle = 0;
+        }
+    }
+
+    private long checkHandle() {
+        if (handle == 0) {
+            throw new IllegalStateException("EraseProgress is already closed");
+        }
+
+        return handle;
+    }
+
+    private static native long create();
+    private static native void destroy(long handle);
+
+    private static native long countBytes(long handle);
+    private static native long countFiles(long handle);
+    private static native int pass(long handle);
+
+    private static native void cancel(long handle);
+    private static native boolean isCancelled(long handle);
+}
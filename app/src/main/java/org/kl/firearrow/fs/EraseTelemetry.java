@@ -0,0 +1,111 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022-2023 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+package org.kl.firearrow.fs;
+
+import androidx.annotation.NonNull;
+
+import java.util.Objects;
+
+/*
+ * Decoder of telemetry array returned by native erase:
+ * [version, total ns, bytes, read/write calls, files, passes, phases],
+ * then (ns, calls) of each phase, then (ns, bytes, calls) of each pass.
+ * Only read/write calls are counted, e.g. sync, unlink, io_uring and mapped
+ * writes take time without calls.
+ */
+public record EraseTelemetry(@NonNull long[] values) {
+    public static final long VERSION = 1;
+
+    private static final int HEADER_SIZE = 7;
+    private static final int PHASE_SIZE = 2;
+    private static final int PASS_SIZE = 3;
+
+    public EraseTelemetry {
+        Objects.requireNonNull(values, "Field values can't be null");
+
+        if (values.length < HEADER_SIZE || values[0] != VERSION) {
+            throw new IllegalArgumentException("Unknown telemetry version");
+        }
+
+        if (values.length != HEADER_SIZE + values[6] * PHASE_SIZE + values[5] * PASS_SIZE) {
+            throw new IllegalArgumentException("Wrong telemetry size: " + values.length);
+        }
+    }
+
+    public long totalNanos() {
+        return values[1];
+    }
+
+    public long countBytes() {
+        return values[2];
+    }
+
+    public long countIoCalls() {
+        return values[3];
+    }
+
+    public long countFiles() {
+        return values[4];
+    }
+
+    public int countPasses() {
+        return (int) values[5];
+    }
+
+    public long phaseNanos(@NonNull ErasePhase phase) {
+        return values[phaseIndex(phase)];
+    }
+
+    public long phaseIoCalls(@NonNull ErasePhase phase) {
+        return values[phaseIndex(phase) + 1];
+    }
+
+    public long passNanos(int pass) {
+        return values[passIndex(pass)];
+    }
+
+    public long passBytes(int pass) {
+        return values[passIndex(pass) + 1];
+    }
+
+    public long passIoCalls(int pass) {
+        return values[passIndex(pass) + 2];
+    }
+
+    private int phaseIndex(ErasePhase phase) {
+        if (phase.ordinal() >= values[6]) {
+            throw new IllegalArgumentException("Phase isn't recorded: " + phase);
+        }
+
+        return HEADER_SIZE + phase.ordinal() * PHASE_SIZE;
+    }
+
+    private int passIndex(int pass) {
+        if (pass < 0 || pass >= countPasses()) {
+            throw new IndexOutOfBoundsException("Pass isn't recorded: " + pass);
+        }
+
+        return HEADER_SIZE + (int) values[6] * PHASE_SIZE + pass * PASS_SIZE;
+    }
+}
@@ -44,10 +44,29 @@ public final class FileManager {
 
     public static native long eraseFile(@NonNull String path, OverwriteMode mode) throws FileException;
 
+    public static native long eraseFile(@NonNull String path, OverwriteMode mode,
+                                        @NonNull EraseOptions options) throws FileException;
+
+    /* times of erase phases and passes, they are decoded by EraseTelemetry */
+    public static native long[] eraseFileWithTelemetry(@NonNull String path, OverwriteMode mode,
+                                                       @NonNull EraseOptions options) throws FileException;
+
     public static native long eraseDirectory(@NonNull String path, boolean recursive) throws FileException;
 
     public static native long eraseDirectory(@NonNull String path, OverwriteMode mode, boolean recursive) throws FileException;
 
+    public static native EraseResult eraseDirectory(@NonNull String path, OverwriteMode mode,
+                                                    boolean recursive, int countThreads) throws FileException;
+
+    public static native EraseResult eraseDirectory(@NonNull String path, OverwriteMode mode, @NonNull EraseOptions options,
+                                                    boolean recursive, int countThreads) throws FileException;
+
+    /* file of write chunk sizes calibrated per filesystem for erases with tuneChunks option, it is kept between launches */
+    public static native void setChunkCache(@NonNull String path);
+
+    /* directory of journals, erase with resumable option continues there after the app is killed */
+    public static native void setJournalDirectory(@NonNull String path);
+
     public static String javaDeleteFile(@NonNull Context context) {
         final var builder = new StringBuilder();
         final long beginTime = System.currentTimeMillis();
@@ -197,9 +216,13 @@ public final class FileManager {
         try {
             builder.append("> Erase directory recursive").append(directoryPath).append("\n");
 
-            final long duration = FileManager.eraseDirectory(directoryPath, true);
+            final EraseResult result = FileManager.eraseDirectory(directoryPath, OverwriteMode.SIMPLE_MODE, true,
+                                                                  Runtime.getRuntime().availableProcessors());
 
-            builder.append("> C++ execution time: ").append(duration).append(" ms\n");
+            builder.append("> Erased ").append(result.countFiles()).append(" files, ")
+                   .append(result.countBytes()).append(" bytes\n");
+            builder.append("> C++ throughput: ").append(String.format("%.2f", result.throughput())).append(" MB/s\n");
+            builder.append("> C++ execution time: ").append(result.duration()).append(" ms\n");
         } catch (FileException e) {
             builder.append("> Erase directory recursive").append(directoryPath)
                    .append(" exception").append(e.getMessage()).append("\n");
@@ -26,9 +26,11 @@ package org.kl.firearrow.fs;
 import lombok.Getter;
 
 public enum OverwriteMode {
+    DISCARD_MODE(0),
     SIMPLE_MODE(1),
     OPENBSD_MODE(3),
-    DOD_MODE(7);
+    DOD_MODE(7),
+    GUTMANN_MODE(35);
 
     @Getter
     private final int number;
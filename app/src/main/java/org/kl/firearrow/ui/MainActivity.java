@@ -34,7 +34,12 @@ import androidx.annotation.Nullable;
 import androidx.appcompat.app.AppCompatActivity;
 import dagger.hilt.android.AndroidEntryPoint;
 
+import java.io.File;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+
 import org.kl.firearrow.R;
+import org.kl.firearrow.fs.FileManager;
 import org.kl.firearrow.setting.CommonSettings;
 import org.kl.firearrow.ui.setting.SettingActivityContract;
 
@@ -44,6 +49,9 @@ public class MainActivity extends AppCompatActivity {
         System.loadLibrary("firearrow");
     }
 
+    private final static String CHUNK_CACHE_FILE = "erase_chunk_sizes";
+    private final static String JOURNAL_DIRECTORY = "erase_journal";
+
     private CommonSettings settings;
 
     private final ActivityResultLauncher<Void> settingLauncher = registerForActivityResult(
@@ -66,10 +74,25 @@ public class MainActivity extends AppCompatActivity {
         super.onCreate(savedInstanceState);
 
         settings.setTheme(getDelegate(), settings.hasDefaultTheme());
+        initFileManager();
 
         setContentView((R.layout.activity_main));
     }
 
+    /* cache file is read and journal directory is created on disk, so keep it off the UI thread */
+    private void initFileManager() {
+        final Context context = getApplicationContext();
+        final ExecutorService executor = Executors.newSingleThreadExecutor();
+
+        executor.execute(() -> {
+            final File directory = context.getNoBackupFilesDir();
+
+            FileManager.setChunkCache(new File(directory, CHUNK_CACHE_FILE).getPath());
+            FileManager.setJournalDirectory(new File(directory, JOURNAL_DIRECTORY).getPath());
+        });
+        executor.shutdown();
+    }
+
     @Override
     public boolean onCreateOptionsMenu(@Nullable Menu menu) {
         final var inflater = getMenuInflater();
@@ -0,0 +1,104 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fs/BufferPool.hpp>
+
+namespace kl::test {
+    using kl::fs::BufferPool;
+    using kl::fs::PooledBuffer;
+
+    TEST(BufferPoolTest, acquireBufferWithRequestedSizeTest) {
+        BufferPool pool(1);
+        PooledBuffer buffer = pool.acquire(4096);
+
+        EXPECT_TRUE(buffer);
+        EXPECT_EQ(buffer.size(), 4096);
+    }
+
+    TEST(BufferPoolTest, reuseReleasedBufferTest) {
+        BufferPool pool(1);
+        std::uint8_t* data = nullptr;
+
+        {
+            PooledBuffer buffer = pool.acquire(4096);
+            data = buffer.get();
+        }
+
+        PooledBuffer buffer = pool.acquire(1024);
+
+        EXPECT_EQ(buffer.get(), data);
+        EXPECT_EQ(buffer.size(), 4096);
+    }
+
+    TEST(BufferPoolTest, skipTooSmallBufferTest) {
+        BufferPool pool(1);
+        std::uint8_t* data = nullptr;
+
+        {
+            PooledBuffer buffer = pool.acquire(512);
+            data = buffer.get();
+        }
+
+        PooledBuffer buffer = pool.acquire(4096);
+
+        EXPECT_NE(buffer.get(), data);
+        EXPECT_EQ(buffer.size(), 4096);
+    }
+
+    TEST(BufferPoolTest, moveBufferReleaseOnceTest) {
+        BufferPool pool(2);
+        PooledBuffer first = pool.acquire(64);
+        std::uint8_t* data = first.get();
+
+        PooledBuffer second = std::move(first);
+
+        EXPECT_FALSE(first);
+        EXPECT_EQ(second.get(), data);
+    }
+
+    TEST(BufferPoolTest, acquireAlignedBufferTest) {
+        BufferPool pool(1);
+        PooledBuffer buffer = pool.acquire(8192, 4096);
+
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.get()) % 4096, 0);
+        EXPECT_EQ(buffer.alignment(), 4096);
+    }
+
+    TEST(BufferPoolTest, skipLessAlignedBufferTest) {
+        BufferPool pool(1);
+        std::uint8_t* data = nullptr;
+
+        {
+            PooledBuffer buffer = pool.acquire(8192);
+            data = buffer.get();
+        }
+
+        PooledBuffer buffer = pool.acquire(8192, 4096);
+
+        EXPECT_NE(buffer.get(), data);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.get()) % 4096, 0);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <util/random/ChaCha20.hpp>
+
+namespace kl::test {
+    using kl::util::random::ChaCha20;
+
+    static std::array<std::uint8_t, ChaCha20::KEY_SIZE> makeKey() {
+        std::array<std::uint8_t, ChaCha20::KEY_SIZE> key = {};
+
+        for (std::size_t i = 0; i < key.size(); ++i) {
+            key[i] = static_cast<std::uint8_t>(i);
+        }
+
+        return key;
+    }
+
+    TEST(ChaCha20Test, matchRfc8439BlockTest) {
+        const std::array<std::uint8_t, ChaCha20::NONCE_SIZE> nonce = {
+            0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00
+        };
+        const std::array<std::uint8_t, 16> expected = {
+            0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4
+        };
+
+        ChaCha20 generator(makeKey(), nonce, 1);
+        std::array<std::uint8_t, ChaCha20::BLOCK_SIZE> block = {};
+        generator.fill(block.data(), block.size());
+
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), block.begin()));
+    }
+
+    TEST(ChaCha20Test, continueKeystreamBetweenCallsTest) {
+        const std::array<std::uint8_t, ChaCha20::NONCE_SIZE> nonce = {};
+
+        ChaCha20 wholeGenerator(makeKey(), nonce);
+        std::vector<std::uint8_t> whole(1024);
+        wholeGenerator.fill(whole.data(), whole.size());
+
+        ChaCha20 splitGenerator(makeKey(), nonce);
+        std::vector<std::uint8_t> split(1024);
+        splitGenerator.fill(split.data(), 256);
+        splitGenerator.fill(split.data() + 256, 768);
+
+        EXPECT_EQ(whole, split);
+    }
+
+    TEST(ChaCha20Test, carryCounterIntoNonceTest) {
+        const std::array<std::uint8_t, ChaCha20::NONCE_SIZE> nonce = {0xff, 0xff, 0xff, 0xff, 0x07};
+        const std::array<std::uint8_t, ChaCha20::NONCE_SIZE> nextNonce = {0x00, 0x00, 0x00, 0x00, 0x08};
+
+        /* wide block crosses counter wrap after its second lane */
+        ChaCha20 wrapGenerator(makeKey(), nonce, 0xfffffffe);
+        std::vector<std::uint8_t> wrapped(4 * ChaCha20::BLOCK_SIZE);
+        wrapGenerator.fill(wrapped.data(), wrapped.size());
+
+        ChaCha20 tailGenerator(makeKey(), nonce, 0xfffffffe);
+        std::vector<std::uint8_t> tail(2 * ChaCha20::BLOCK_SIZE);
+        tailGenerator.fill(tail.data(), tail.size());
+
+        ChaCha20 nextGenerator(makeKey(), nextNonce);
+        std::vector<std::uint8_t> next(2 * ChaCha20::BLOCK_SIZE);
+        nextGenerator.fill(next.data(), next.size());
+
+        EXPECT_TRUE(std::equal(tail.begin(), tail.end(), wrapped.begin()));
+        EXPECT_TRUE(std::equal(next.begin(), next.end(), wrapped.begin() + 2 * ChaCha20::BLOCK_SIZE));
+
+        /* next wide block continues after nonce carry */
+        std::vector<std::uint8_t> after(4 * ChaCha20::BLOCK_SIZE);
+        wrapGenerator.fill(after.data(), after.size());
+
+        std::vector<std::uint8_t> expected(6 * ChaCha20::BLOCK_SIZE);
+        ChaCha20(makeKey(), nextNonce).fill(expected.data(), expected.size());
+        EXPECT_TRUE(std::equal(after.begin(), after.end(), expected.begin() + 2 * ChaCha20::BLOCK_SIZE));
+    }
+
+    TEST(ChaCha20Test, fillFullByteRangeTest) {
+        ChaCha20 generator = ChaCha20::fromEntropy();
+        std::vector<std::uint8_t> data(64 * 1024);
+        generator.fill(data.data(), data.size());
+
+        std::array<bool, 256> seen = {};
+
+        for (std::uint8_t value : data) {
+            seen[value] = true;
+        }
+
+        EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](bool value) { return value; }));
+    }
+}
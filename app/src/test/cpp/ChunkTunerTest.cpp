@@ -0,0 +1,95 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <fs/ChunkTuner.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::BufferPool;
+    using kl::fs::ChunkTuner;
+
+    class ChunkTunerTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_FALSE(directory.path().empty());
+            cachePath = directory.path() / "chunk_sizes";
+
+            fd = ::open(directory.path().c_str(), O_RDONLY | O_DIRECTORY);
+            ASSERT_NE(fd, -1);
+
+            struct stat info = {};
+            ASSERT_EQ(::fstat(fd, &info), 0);
+            device = info.st_dev;
+        }
+
+        void TearDown() override {
+            ::close(fd);
+        }
+
+        TempDirectory directory;
+        std::filesystem::path cachePath;
+        dev_t device = 0;
+        int fd = -1;
+    };
+
+    TEST_F(ChunkTunerTest, calibrateAndPersistTest) {
+        BufferPool pool(1);
+        ChunkTuner tuner;
+        tuner.setCachePath(cachePath);
+
+        const std::uint32_t size = tuner.chunkSize(pool, fd, device);
+        const auto& candidates = ChunkTuner::CANDIDATE_SIZES;
+
+        ASSERT_NE(std::find(candidates.begin(), candidates.end(), size), candidates.end());
+        EXPECT_EQ(tuner.chunkSize(pool, fd, device), size);
+
+        std::uintmax_t storedDevice = 0;
+        std::uint32_t storedSize = 0;
+        std::ifstream(cachePath) >> storedDevice >> storedSize;
+
+        EXPECT_EQ(storedDevice, static_cast<std::uintmax_t>(device));
+        EXPECT_EQ(storedSize, size);
+    }
+
+    TEST_F(ChunkTunerTest, useCachedSizeTest) {
+        std::ofstream(cachePath) << static_cast<std::uintmax_t>(device) << ' ' << ChunkTuner::CANDIDATE_SIZES[1] << '\n';
+
+        BufferPool pool(1);
+        ChunkTuner tuner;
+        tuner.setCachePath(cachePath);
+
+        EXPECT_EQ(tuner.chunkSize(pool, fd, device), ChunkTuner::CANDIDATE_SIZES[1]);
+        EXPECT_EQ(std::distance(std::filesystem::directory_iterator(directory.path()), {}), 1);
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <fs/DeviceScheduler.hpp>
+
+namespace kl::test {
+    using kl::fs::DeviceBatch;
+    using kl::fs::DeviceScheduler;
+
+    TEST(DeviceSchedulerTest, acquireAllFilesTest) {
+        DeviceScheduler scheduler(2);
+        const std::size_t countFiles = DeviceScheduler::BATCH_SIZE * 3 + 5;
+
+        for (std::size_t i = 0; i < countFiles; ++i) {
+            scheduler.add(static_cast<dev_t>(i % 2 + 1), i);
+        }
+
+        ASSERT_EQ(scheduler.countDevices(), 2);
+
+        std::set<std::size_t> files;
+
+        while (auto batch = scheduler.acquire()) {
+            ASSERT_GT(batch->countFiles, 0);
+            ASSERT_LE(batch->countFiles, DeviceScheduler::BATCH_SIZE);
+
+            files.insert(batch->files, batch->files + batch->countFiles);
+            scheduler.release(*batch, 0);
+        }
+
+        EXPECT_EQ(files.size(), countFiles);
+        EXPECT_EQ(*files.rbegin(), countFiles - 1);
+    }
+
+    TEST(DeviceSchedulerTest, stopWaitingWorkerTest) {
+        DeviceScheduler scheduler(2);
+
+        for (std::size_t i = 0; i < DeviceScheduler::BATCH_SIZE * 3; ++i) {
+            scheduler.add(1, i);
+        }
+
+        /* single device starts with all workers, so third worker waits */
+        auto batch = scheduler.acquire();
+        ASSERT_TRUE(batch.has_value());
+
+        auto secondBatch = scheduler.acquire();
+        ASSERT_TRUE(secondBatch.has_value());
+
+        std::thread worker([&scheduler] {
+            EXPECT_FALSE(scheduler.acquire().has_value());
+        });
+
+        scheduler.stop();
+        worker.join();
+
+        scheduler.release(*batch, 0);
+        scheduler.release(*secondBatch, 0);
+        EXPECT_FALSE(scheduler.acquire().has_value());
+    }
+
+    TEST(DeviceSchedulerTest, shareWorkersBetweenDevicesTest) {
+        DeviceScheduler scheduler(4);
+
+        for (std::size_t i = 0; i < DeviceScheduler::BATCH_SIZE * 8; ++i) {
+            scheduler.add(static_cast<dev_t>(i % 2 + 1), i);
+        }
+
+        std::vector<DeviceBatch> batches;
+
+        for (std::size_t i = 0; i < 4; ++i) {
+            auto batch = scheduler.acquire();
+            ASSERT_TRUE(batch.has_value());
+            batches.push_back(*batch);
+        }
+
+        /* each device has half of workers */
+        EXPECT_EQ(std::count_if(batches.begin(), batches.end(), [](const DeviceBatch& batch) {
+            return batch.queue == 0;
+        }), 2);
+
+        for (const auto& batch : batches) {
+            scheduler.release(batch, 0);
+        }
+
+        scheduler.stop();
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include <fs/DirectoryWalker.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::DirectoryWalker;
+
+    class DirectoryWalkerTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_FALSE(temp.path().empty());
+            root = temp.path() / "walk";
+            std::filesystem::create_directories(root / "a" / "b");
+            std::filesystem::create_directories(root / "c");
+
+            std::ofstream(root / "first.txt") << "first";
+            std::ofstream(root / "a" / "second.txt") << "second";
+            std::ofstream(root / "a" / "b" / "third.txt") << "third";
+            std::filesystem::create_symlink(root / "first.txt", root / "c" / "link");
+        }
+
+        TempDirectory temp;
+        std::filesystem::path root;
+    };
+
+    TEST_F(DirectoryWalkerTest, collectFilesTest) {
+        DirectoryWalker walker;
+
+        ASSERT_FALSE(walker.walk(root, false).hasError());
+        ASSERT_EQ(walker.files().size(), 1);
+        EXPECT_EQ(walker.files()[0].name, "first.txt");
+        EXPECT_EQ(walker.directories().size(), 1);
+
+        ASSERT_FALSE(walker.walk(root, true).hasError());
+        EXPECT_EQ(walker.files().size(), 3);
+        EXPECT_EQ(walker.directories().size(), 4);
+        EXPECT_EQ(walker.countSkipped(), 1);
+
+        for (const auto& file : walker.files()) {
+            const auto& directory = walker.directories()[file.directory];
+            EXPECT_TRUE(std::filesystem::is_regular_file(directory.path + '/' + file.name));
+        }
+
+        for (const auto& directory : walker.directories()) {
+            struct stat directoryInfo = {};
+            ASSERT_EQ(::stat(directory.path.c_str(), &directoryInfo), 0);
+            EXPECT_EQ(directory.device, directoryInfo.st_dev);
+            EXPECT_EQ(directory.inode, directoryInfo.st_ino);
+        }
+    }
+
+    TEST_F(DirectoryWalkerTest, removeDirectoriesBottomUpTest) {
+        DirectoryWalker walker;
+
+        ASSERT_FALSE(walker.walk(root, true).hasError());
+
+        for (const auto& file : walker.files()) {
+            std::filesystem::remove(walker.directories()[file.directory].path + '/' + file.name);
+        }
+
+        auto result = walker.removeDirectories();
+
+        ASSERT_TRUE(result.hasValue());
+        EXPECT_EQ(result.value(), 2);
+        EXPECT_TRUE(std::filesystem::exists(root));
+        EXPECT_FALSE(std::filesystem::exists(root / "a"));
+        EXPECT_TRUE(std::filesystem::is_symlink(root / "c" / "link"));
+    }
+
+    TEST_F(DirectoryWalkerTest, rejectReplacedDirectoryTest) {
+        DirectoryWalker walker;
+        const auto moved = root.string() + ".moved";
+        const auto other = root.string() + ".other";
+
+        ASSERT_FALSE(walker.walk(root, true).hasError());
+        EXPECT_TRUE(walker.openDirectory(1).hasValue());
+
+        /* root is swapped for symlink to other tree with the same layout */
+        std::filesystem::rename(root, moved);
+        std::filesystem::create_directories(std::filesystem::path(other) / "a" / "b");
+        std::filesystem::create_directories(std::filesystem::path(other) / "c");
+        std::filesystem::create_directory_symlink(other, root);
+
+        EXPECT_TRUE(walker.openDirectory(0).hasError());
+        EXPECT_TRUE(walker.openDirectory(1).hasError());
+        EXPECT_TRUE(walker.removeDirectories().hasError());
+        EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(other) / "a" / "b"));
+    }
+}
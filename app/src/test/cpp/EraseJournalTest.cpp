@@ -0,0 +1,112 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <fs/EraseJournal.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::EraseJournal;
+    using kl::fs::JournalFile;
+    using kl::fs::OverwriteMode;
+
+    class EraseJournalTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_FALSE(temp.path().empty());
+            directory = temp.path() / "journal";
+            filePath = temp.path() / "journaled.bin";
+            std::ofstream(filePath) << "journaled file";
+
+            fd = ::open(filePath.c_str(), O_RDWR);
+            ASSERT_NE(fd, -1);
+
+            journal.setDirectory(directory);
+        }
+
+        void TearDown() override {
+            ::close(fd);
+        }
+
+        JournalFile openJournal(OverwriteMode mode) {
+            struct stat fileInfo = {};
+            EXPECT_EQ(::fstat(fd, &fileInfo), 0);
+
+            auto result = journal.open(fd, fileInfo, mode);
+            EXPECT_FALSE(result.hasError());
+
+            return std::move(result.value());
+        }
+
+        TempDirectory temp;
+        EraseJournal journal;
+        std::filesystem::path directory;
+        std::filesystem::path filePath;
+        int fd = -1;
+    };
+
+    TEST_F(EraseJournalTest, resumeFromLastCommitTest) {
+        {
+            JournalFile file = openJournal(OverwriteMode::DOD_MODE);
+            EXPECT_EQ(file.pass(), 0);
+
+            ASSERT_FALSE(file.commit(2, 0).hasError());
+            ASSERT_FALSE(file.commit(3, 8192).hasError());
+        }
+
+        JournalFile file = openJournal(OverwriteMode::DOD_MODE);
+
+        EXPECT_EQ(file.pass(), 3);
+        EXPECT_EQ(file.offset(), 8192);
+    }
+
+    TEST_F(EraseJournalTest, ignoreOtherModeAndSizeTest) {
+        {
+            JournalFile file = openJournal(OverwriteMode::DOD_MODE);
+            ASSERT_FALSE(file.commit(4, 0).hasError());
+        }
+
+        EXPECT_EQ(openJournal(OverwriteMode::OPENBSD_MODE).pass(), 0);
+
+        ASSERT_EQ(::ftruncate(fd, 4096), 0);
+        EXPECT_EQ(openJournal(OverwriteMode::DOD_MODE).pass(), 0);
+    }
+
+    TEST_F(EraseJournalTest, removeCompletedJournalTest) {
+        JournalFile file = openJournal(OverwriteMode::SIMPLE_MODE);
+        ASSERT_FALSE(file.commit(2, 0).hasError());
+
+        file.remove();
+
+        EXPECT_TRUE(std::filesystem::is_empty(directory));
+    }
+}
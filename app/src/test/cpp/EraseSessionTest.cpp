@@ -0,0 +1,341 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <linux/falloc.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fs/EraseSession.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::BufferPool;
+    using kl::fs::EraseOptions;
+    using kl::fs::EraseProgress;
+    using kl::fs::EraseSession;
+    using kl::fs::EraseTelemetry;
+    using kl::fs::OverwriteMode;
+
+    /* discard of file, which is opened by test too to see its extents after each step */
+    class EraseSessionDiscardTest : public ::testing::Test {
+    protected:
+        static constexpr std::size_t FILE_SIZE = 1024 * 1024;
+
+        void SetUp() override {
+            ASSERT_FALSE(directory.path().empty());
+            path = directory.path() / "discard.bin";
+            std::ofstream(path, std::ios::binary) << std::string(FILE_SIZE, 'x');
+
+            fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+            ASSERT_NE(fd, -1);
+        }
+
+        void TearDown() override {
+            ::close(fd);
+        }
+
+        bool punchSupported() const {
+            TempFile probe;
+            return probe.fd() != -1 && ::ftruncate(probe.fd(), 4096) == 0 &&
+                   ::fallocate(probe.fd(), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, 4096) == 0;
+        }
+
+        bool hasData() const {
+            return ::lseek(fd, 0, SEEK_DATA) != -1 || errno != ENXIO;
+        }
+
+        std::string readFile() const {
+            std::string data(FILE_SIZE, '?');
+            EXPECT_EQ(::pread(fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+            return data;
+        }
+
+        void discard(const EraseOptions& options) {
+            EraseSession session(pool);
+            ASSERT_FALSE(session.init(path, OverwriteMode::DISCARD_MODE, options).hasError());
+            ASSERT_FALSE(session.prepareFile().hasError());
+            ASSERT_FALSE(session.overwriteFile().hasError());
+            session.closeFile();
+        }
+
+        TempDirectory directory;
+        BufferPool pool{1};
+        std::filesystem::path path;
+        int fd = -1;
+    };
+
+    TEST_F(EraseSessionDiscardTest, punchHoleTest) {
+        if (!punchSupported()) {
+            GTEST_SKIP() << "Filesystem doesn't punch holes";
+        }
+
+        EraseTelemetry telemetry;
+        EraseOptions options;
+        options.telemetry = &telemetry;
+
+        discard(options);
+
+        /* every extent is deallocated, size is kept and nothing is written */
+        EXPECT_FALSE(hasData());
+        EXPECT_EQ(readFile(), std::string(FILE_SIZE, '\0'));
+        EXPECT_EQ(telemetry.countPasses, 0);
+        EXPECT_EQ(telemetry.passBytes[0], 0);
+
+        struct stat fileInfo = {};
+        ASSERT_EQ(::fstat(fd, &fileInfo), 0);
+        EXPECT_EQ(fileInfo.st_size, FILE_SIZE);
+        EXPECT_EQ(fileInfo.st_blocks, 0);
+    }
+
+    TEST_F(EraseSessionDiscardTest, punchAfterPatternPassTest) {
+        if (!punchSupported()) {
+            GTEST_SKIP() << "Filesystem doesn't punch holes";
+        }
+
+        EraseTelemetry telemetry;
+        EraseOptions options;
+        options.patternPass = true;
+        options.telemetry = &telemetry;
+
+        discard(options);
+
+        /* zero pass is written and flushed first, so close doesn't bring data back after punch */
+        EXPECT_EQ(telemetry.passBytes[0], FILE_SIZE);
+        EXPECT_FALSE(hasData());
+        EXPECT_EQ(readFile(), std::string(FILE_SIZE, '\0'));
+    }
+
+    TEST_F(EraseSessionDiscardTest, fallBackToZeroPassTest) {
+        if (punchSupported()) {
+            GTEST_SKIP() << "Filesystem punches holes, fallback isn't reached";
+        }
+
+        EraseTelemetry telemetry;
+        EraseOptions options;
+        options.telemetry = &telemetry;
+
+        discard(options);
+
+        EXPECT_EQ(telemetry.passBytes[0], FILE_SIZE);
+        EXPECT_EQ(readFile(), std::string(FILE_SIZE, '\0'));
+    }
+
+    TEST(EraseSessionTest, cancelVerifiedPassTest) {
+        TempDirectory directory;
+        ASSERT_FALSE(directory.path().empty());
+
+        const auto path = directory.path() / "cancel.bin";
+        {
+            std::ofstream stream(path, std::ios::binary);
+            std::vector<char> chunk(1 << 20, 'x');
+
+            for (int i = 0; i < 16; ++i) {
+                stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            }
+        }
+
+        BufferPool pool(2);
+        EraseProgress progress;
+        EraseOptions options;
+        options.verify = true;
+        options.progress = &progress;
+        options.bufferSize = 4096;
+
+        std::thread canceller([&progress] {
+            while (progress.countBytes.load() == 0) {
+                std::this_thread::yield();
+            }
+
+            progress.cancel();
+        });
+
+        EraseSession session(pool);
+        auto result = session.erase(path, OverwriteMode::DOD_MODE, options);
+        canceller.join();
+
+        EXPECT_TRUE(result.hasError());
+        EXPECT_TRUE(std::filesystem::exists(path));
+
+        /* session is reused after cancel, verifier of previous file must be stopped */
+        progress.cancelled = false;
+        EXPECT_FALSE(session.erase(path, OverwriteMode::SIMPLE_MODE, options).hasError());
+        EXPECT_FALSE(std::filesystem::exists(path));
+    }
+
+    TEST(EraseSessionTest, deferBatchSyncTest) {
+        TempDirectory temp;
+        ASSERT_FALSE(temp.path().empty());
+
+        const auto& directory = temp.path();
+
+        std::vector<std::filesystem::path> paths;
+
+        for (int i = 0; i < 3; ++i) {
+            paths.push_back(directory / ("file" + std::to_string(i)));
+            std::ofstream(paths.back(), std::ios::binary) << std::string(10000, 'x');
+        }
+
+        BufferPool pool(2);
+        EraseOptions options;
+        options.syncPolicy = kl::fs::SyncPolicy::BATCH_SYNC;
+        options.syncBatchSize = 2;
+
+        EraseSession session(pool);
+
+        /* first file waits for its batch overwritten, but not removed */
+        ASSERT_FALSE(session.erase(paths[0], OverwriteMode::SIMPLE_MODE, options).hasError());
+        ASSERT_TRUE(std::filesystem::exists(paths[0]));
+        {
+            std::ifstream stream(paths[0], std::ios::binary);
+            const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            EXPECT_EQ(data, std::string(10000, '\0'));
+        }
+
+        /* full batch is synced and removed */
+        ASSERT_FALSE(session.erase(paths[1], OverwriteMode::SIMPLE_MODE, options).hasError());
+        EXPECT_FALSE(std::filesystem::exists(paths[0]));
+        EXPECT_FALSE(std::filesystem::exists(paths[1]));
+
+        /* rest of batch is removed by explicit sync */
+        ASSERT_FALSE(session.erase(paths[2], OverwriteMode::SIMPLE_MODE, options).hasError());
+        EXPECT_TRUE(std::filesystem::exists(paths[2]));
+        ASSERT_FALSE(session.syncBatch().hasError());
+        EXPECT_FALSE(std::filesystem::exists(paths[2]));
+        EXPECT_TRUE(std::filesystem::is_empty(directory));
+    }
+
+    TEST(EraseSessionTest, rejectSymlinkTest) {
+        TempDirectory directory;
+        ASSERT_FALSE(directory.path().empty());
+
+        const auto target = directory.path() / "target.txt";
+        const auto link = directory.path() / "link";
+        std::ofstream(target) << "target";
+        std::filesystem::create_symlink(target, link);
+
+        BufferPool pool(1);
+        EraseSession session(pool);
+        auto result = session.init(link, OverwriteMode::SIMPLE_MODE);
+
+        /* O_NOFOLLOW fails open of link itself, target is never touched */
+        ASSERT_TRUE(result.hasError());
+        EXPECT_NE(result.error().message.get().find("symlink"), std::string::npos);
+        EXPECT_TRUE(std::filesystem::is_symlink(link));
+
+        std::ifstream stream(target);
+        const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(data, "target");
+    }
+
+    TEST(EraseSessionTest, refuseHardLinkTest) {
+        TempDirectory directory;
+        ASSERT_FALSE(directory.path().empty());
+
+        const auto path = directory.path() / "file.txt";
+        const auto link = directory.path() / "hard.txt";
+        std::ofstream(path) << "shared";
+        std::filesystem::create_hard_link(path, link);
+
+        BufferPool pool(1);
+        EraseSession session(pool);
+        auto result = session.erase(path, OverwriteMode::SIMPLE_MODE);
+
+        ASSERT_TRUE(result.hasError());
+        EXPECT_EQ(result.error().message.get(), "Count hard link must only be one");
+        EXPECT_TRUE(std::filesystem::exists(path));
+
+        std::ifstream stream(link);
+        const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(data, "shared");
+    }
+
+    TEST(EraseSessionTest, removeRelativeToParentTest) {
+        TempDirectory temp;
+        ASSERT_FALSE(temp.path().empty());
+
+        const auto directory = temp.path() / "parent";
+        const auto moved = temp.path() / "moved";
+        const std::string name = "file.txt";
+        std::filesystem::create_directory(directory);
+        std::ofstream(directory / name) << std::string(4096, 'x');
+
+        const int directoryFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        ASSERT_NE(directoryFd, -1);
+
+        BufferPool pool(1);
+        EraseSession session(pool);
+        ASSERT_FALSE(session.init(directoryFd, name, OverwriteMode::SIMPLE_MODE).hasError());
+
+        /* path is changed after open, remove must still find the file by descriptors */
+        std::filesystem::rename(directory, moved);
+
+        const int notifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        ASSERT_NE(notifyFd, -1);
+        ASSERT_NE(::inotify_add_watch(notifyFd, moved.c_str(), IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE), -1);
+
+        ASSERT_FALSE(session.prepareFile().hasError());
+        ASSERT_FALSE(session.overwriteFile().hasError());
+        session.closeFile();
+        ASSERT_FALSE(session.removeFile().hasError());
+
+        EXPECT_TRUE(std::filesystem::is_empty(moved));
+        EXPECT_NE(::fcntl(directoryFd, F_GETFD), -1);
+
+        /* file is renamed to random name of the same length, then that name is unlinked */
+        alignas(inotify_event) char events[4096];
+        const ssize_t size = ::read(notifyFd, events, sizeof(events));
+        ASSERT_GT(size, 0);
+
+        std::vector<std::pair<std::uint32_t, std::string>> changes;
+
+        for (ssize_t offset = 0; offset < size;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(events + offset);
+            changes.emplace_back(event->mask & (IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE), event->name);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+
+        ASSERT_EQ(changes.size(), 3);
+        EXPECT_EQ(changes[0], std::make_pair(std::uint32_t{IN_MOVED_FROM}, name));
+        EXPECT_EQ(changes[1].first, IN_MOVED_TO);
+        EXPECT_EQ(changes[1].second.size(), name.size());
+        EXPECT_NE(changes[1].second, name);
+        EXPECT_EQ(changes[2], std::make_pair(std::uint32_t{IN_DELETE}, changes[1].second));
+
+        ::close(notifyFd);
+        ::close(directoryFd);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <fs/EraseTelemetry.hpp>
+
+namespace kl::test {
+    using kl::fs::ErasePhase;
+    using kl::fs::EraseTelemetry;
+    using kl::fs::PhaseTimer;
+    using kl::fs::TelemetrySample;
+
+    TEST(EraseTelemetryTest, arrayLayoutTest) {
+        EraseTelemetry telemetry;
+        const TelemetrySample begin = TelemetrySample::now();
+        TelemetrySample end = TelemetrySample::now();
+        end.time = begin.time + std::chrono::nanoseconds(1000);
+
+        telemetry.addPhase(ErasePhase::SYNC_PHASE, begin, end);
+        telemetry.addPass(2, begin, end, 4096, 400, 0);
+
+        const std::vector<std::int64_t> values = telemetry.toArray();
+        const std::size_t passIndex = EraseTelemetry::HEADER_SIZE +
+                                      EraseTelemetry::COUNT_PHASES * EraseTelemetry::PHASE_SIZE +
+                                      1 * EraseTelemetry::PASS_SIZE;
+
+        ASSERT_EQ(values.size(), passIndex + EraseTelemetry::PASS_SIZE);
+        EXPECT_EQ(values[0], EraseTelemetry::VERSION);
+        EXPECT_EQ(values[2], 4096);
+        EXPECT_EQ(values[5], 2);
+        EXPECT_EQ(values[6], static_cast<std::int64_t>(EraseTelemetry::COUNT_PHASES));
+        EXPECT_EQ(values[EraseTelemetry::HEADER_SIZE + 3 * EraseTelemetry::PHASE_SIZE], 1000);
+        EXPECT_EQ(values[passIndex], 600);
+        EXPECT_EQ(values[passIndex + 1], 4096);
+    }
+
+    TEST(EraseTelemetryTest, mergeTest) {
+        EraseTelemetry first;
+        EraseTelemetry second;
+
+        first.countFiles = 2;
+        first.phaseNanos[0] = 10;
+        first.countPasses = 1;
+        second.countFiles = 3;
+        second.phaseNanos[0] = 5;
+        second.countPasses = 3;
+
+        {
+            PhaseTimer timer(nullptr, ErasePhase::OPEN_PHASE); /* no telemetry, nothing to record */
+        }
+
+        first.merge(second);
+
+        EXPECT_EQ(first.countFiles, 5);
+        EXPECT_EQ(first.phaseNanos[0], 15);
+        EXPECT_EQ(first.countPasses, 3);
+    }
+}
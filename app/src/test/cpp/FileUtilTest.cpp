@@ -0,0 +1,101 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <vector>
+
+#include <fs/FileUtil.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::FileExtent;
+
+    class FileUtilTest : public ::testing::Test {
+    protected:
+        static constexpr std::uintmax_t FILE_SIZE = 4 * 1024 * 1024;
+        static constexpr std::size_t ALIGNMENT = 64 * 1024;
+
+        void SetUp() override {
+            fd = file.fd();
+            ASSERT_NE(fd, -1);
+            ASSERT_EQ(::ftruncate(fd, FILE_SIZE), 0);
+        }
+
+        void writeAt(std::uintmax_t offset, std::size_t size) {
+            const std::vector<std::uint8_t> data(size, 0x5A);
+            ASSERT_EQ(::pwrite(fd, data.data(), data.size(), static_cast<off_t>(offset)), size);
+        }
+
+        TempFile file;
+        int fd = -1;
+    };
+
+    TEST_F(FileUtilTest, findSparseExtentsTest) {
+        auto empty = kl::fs::findExtents(fd, FILE_SIZE, ALIGNMENT);
+        ASSERT_TRUE(empty.hasValue());
+
+        if (!empty.value().empty()) {
+            GTEST_SKIP() << "Filesystem doesn't report holes";
+        }
+
+        /* two writes in one aligned block, one spanning blocks and one at end of file */
+        writeAt(1024 * 1024 + 10, 100);
+        writeAt(1024 * 1024 + 5000, 10);
+        writeAt(2 * 1024 * 1024 - 10, 20);
+        writeAt(FILE_SIZE - 10, 10);
+
+        auto result = kl::fs::findExtents(fd, FILE_SIZE, ALIGNMENT);
+        ASSERT_TRUE(result.hasValue());
+
+        const std::vector<FileExtent>& extents = result.value();
+        ASSERT_EQ(extents.size(), 3);
+
+        EXPECT_EQ(extents[0].offset, 1024 * 1024);
+        EXPECT_EQ(extents[0].length, ALIGNMENT);
+        EXPECT_EQ(extents[1].offset, 2 * 1024 * 1024 - ALIGNMENT);
+        EXPECT_EQ(extents[1].length, 2 * ALIGNMENT);
+        EXPECT_EQ(extents[2].offset, FILE_SIZE - ALIGNMENT);
+        EXPECT_EQ(extents[2].length, ALIGNMENT);
+    }
+
+    TEST_F(FileUtilTest, mergeAdjacentExtentsTest) {
+        writeAt(0, 100);
+        writeAt(ALIGNMENT + 100, 100);
+
+        auto result = kl::fs::findExtents(fd, FILE_SIZE, ALIGNMENT);
+        ASSERT_TRUE(result.hasValue());
+
+        const std::vector<FileExtent>& extents = result.value();
+        ASSERT_FALSE(extents.empty());
+
+        /* without holes support whole file is one extent, otherwise both blocks merge */
+        EXPECT_EQ(extents[0].offset, 0);
+        EXPECT_GE(extents[0].length, 2 * ALIGNMENT);
+    }
+}
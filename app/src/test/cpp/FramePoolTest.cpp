@@ -0,0 +1,74 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <coroutine/FramePool.hpp>
+#include <coroutine/Generator.hpp>
+
+namespace kl::test {
+    using kl::coroutine::Generator;
+
+    static Generator<int> countFrom(int begin, int count) {
+        for (int i = 0; i < count; ++i) {
+            co_yield (begin + i);
+        }
+    }
+
+    TEST(FramePoolTest, reuseFrameTest) {
+        void* first = kl::coroutine::allocateFrame(100);
+        kl::coroutine::deallocateFrame(first, 100);
+
+        /* the same size class is 128 bytes */
+        void* second = kl::coroutine::allocateFrame(120);
+        EXPECT_EQ(first, second);
+        kl::coroutine::deallocateFrame(second, 120);
+
+        void* large = kl::coroutine::allocateFrame(kl::coroutine::MAX_FRAME_SIZE + 1);
+        EXPECT_NE(large, nullptr);
+        kl::coroutine::deallocateFrame(large, kl::coroutine::MAX_FRAME_SIZE + 1);
+    }
+
+    TEST(FramePoolTest, crossThreadFrameTest) {
+        void* frame = kl::coroutine::allocateFrame(200);
+
+        std::thread([frame] { kl::coroutine::deallocateFrame(frame, 200); }).join();
+
+        kl::coroutine::setFramePoolEnabled(false);
+        void* other = kl::coroutine::allocateFrame(200);
+        kl::coroutine::setFramePoolEnabled(true);
+        kl::coroutine::deallocateFrame(other, 200);
+
+        int sum = 0;
+
+        for (int i = 0; i < 100; ++i) {
+            for (int value : countFrom(0, 10)) {
+                sum += value;
+            }
+        }
+
+        EXPECT_EQ(sum, 4500);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <coroutine/Oneshot.hpp>
+#include <coroutine/ThreadPool.hpp>
+
+namespace kl::test {
+    using kl::coroutine::Oneshot;
+    using kl::coroutine::ThreadPool;
+
+    static Oneshot<std::string> concatOnPool(ThreadPool& pool, std::string prefix) {
+        co_await pool.schedule();
+        co_return prefix + "-suffix";
+    }
+
+    static Oneshot<void> throwOnPool(ThreadPool& pool) {
+        co_await pool.schedule();
+        throw std::runtime_error("coroutine error");
+    }
+
+    static Oneshot<int> returnInline(int value) {
+        co_return value;
+    }
+
+    TEST(OneshotTest, resultTest) {
+        ThreadPool pool(2);
+
+        Oneshot<int> ready = returnInline(42);
+        EXPECT_TRUE(ready.isReady());
+        EXPECT_EQ(ready.get(), 42);
+
+        EXPECT_EQ(concatOnPool(pool, "prefix").get(), "prefix-suffix");
+    }
+
+    TEST(OneshotTest, exceptionTest) {
+        ThreadPool pool(2);
+        Oneshot<void> oneshot = throwOnPool(pool);
+
+        EXPECT_THROW(oneshot.get(), std::runtime_error);
+    }
+
+    TEST(OneshotTest, detachTest) {
+        ThreadPool pool(2);
+
+        for (int i = 0; i < 1000; ++i) {
+            /* frame is destroyed by coroutine or by handle, whichever finishes last */
+            [[maybe_unused]] Oneshot<std::string> oneshot = concatOnPool(pool, std::to_string(i));
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <fs/PassSchedule.hpp>
+
+namespace kl::test {
+    using kl::fs::OverwriteMode;
+    using kl::fs::OverwritePass;
+    using kl::fs::PassKind;
+    using kl::fs::OVERWRITE_MODE;
+
+    TEST(PassScheduleTest, countPassesOfModeTest) {
+        for (OverwriteMode mode : OVERWRITE_MODE.values()) {
+            EXPECT_EQ(kl::fs::passSchedule(mode).size(), static_cast<std::size_t>(OVERWRITE_MODE.ordinal(mode)));
+        }
+    }
+
+    TEST(PassScheduleTest, gutmannScheduleTest) {
+        const auto schedule = kl::fs::passSchedule(OverwriteMode::GUTMANN_MODE);
+        const auto isRandom = [](const OverwritePass& pass) { return pass.kind == PassKind::RANDOM_PASS; };
+
+        EXPECT_TRUE(std::all_of(schedule.begin(), schedule.begin() + 4, isRandom));
+        EXPECT_TRUE(std::all_of(schedule.end() - 4, schedule.end(), isRandom));
+        EXPECT_EQ(std::count_if(schedule.begin(), schedule.end(), isRandom), 8);
+
+        /* the same pattern repeated in schedule is shared, e.g. 0x55 of passes 5 and 15 */
+        EXPECT_EQ(schedule[4], schedule[14]);
+        EXPECT_EQ(schedule[6], schedule[25]);
+        EXPECT_EQ(schedule[6].patternSize, 3);
+    }
+
+    TEST(PassScheduleTest, keepPatternPhaseAcrossChunksTest) {
+        const auto schedule = kl::fs::passSchedule(OverwriteMode::GUTMANN_MODE);
+        const OverwritePass& pass = schedule[6];
+
+        EXPECT_EQ(kl::fs::patternPeriod(schedule), 3);
+        EXPECT_EQ(kl::fs::patternPeriod(kl::fs::passSchedule(OverwriteMode::DOD_MODE)), 1);
+
+        const std::size_t chunkSize = kl::fs::alignChunkSize(4096, kl::fs::patternPeriod(schedule), 512);
+        EXPECT_EQ(chunkSize % 3, 0);
+        EXPECT_EQ(chunkSize % 512, 0);
+        EXPECT_GE(chunkSize, 4096);
+
+        std::vector<std::uint8_t> chunk(chunkSize);
+        kl::fs::fillPattern(chunk.data(), chunk.size(), pass);
+
+        /* two whole chunks and a tail, each one starts from beginning of buffer as writers do */
+        std::vector<std::uint8_t> data;
+        data.insert(data.end(), chunk.begin(), chunk.end());
+        data.insert(data.end(), chunk.begin(), chunk.end());
+        data.insert(data.end(), chunk.begin(), chunk.begin() + 100);
+
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            ASSERT_EQ(data[i], pass.pattern[i % 3]) << "offset " << i;
+        }
+    }
+}
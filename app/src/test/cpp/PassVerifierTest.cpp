@@ -0,0 +1,85 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <vector>
+
+#include <fs/PassVerifier.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::BufferPool;
+    using kl::fs::PassVerifier;
+
+    class PassVerifierTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            pattern.assign(4096, 0xA5);
+
+            fd = file.fd();
+            ASSERT_NE(fd, -1);
+
+            for (int i = 0; i < 4; ++i) {
+                ASSERT_EQ(::pwrite(fd, pattern.data(), pattern.size(), i * pattern.size()), pattern.size());
+            }
+        }
+
+        TempFile file;
+        std::vector<std::uint8_t> pattern;
+        int fd = -1;
+    };
+
+    TEST_F(PassVerifierTest, acceptMatchedRangesTest) {
+        BufferPool pool(1);
+        PassVerifier verifier(pool);
+
+        verifier.start(fd, pattern.data(), pattern.size());
+        verifier.submit(0, 2 * pattern.size());
+        verifier.submit(2 * pattern.size(), 2 * pattern.size());
+
+        EXPECT_FALSE(verifier.finish().hasError());
+        EXPECT_EQ(verifier.countMismatches(), 0);
+    }
+
+    TEST_F(PassVerifierTest, reportMismatchedOffsetTest) {
+        const std::uint8_t corrupted = 0x00;
+        ASSERT_EQ(::pwrite(fd, &corrupted, 1, 2 * pattern.size() + 100), 1);
+
+        BufferPool pool(1);
+        PassVerifier verifier(pool);
+
+        verifier.start(fd, pattern.data(), pattern.size());
+        verifier.submit(0, 4 * pattern.size());
+
+        EXPECT_FALSE(verifier.finish().hasError());
+        EXPECT_EQ(verifier.countMismatches(), 1);
+        ASSERT_EQ(verifier.mismatches().size(), 1);
+        EXPECT_EQ(verifier.mismatches()[0], 2 * pattern.size() + 100);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#include <fs/RangeWriter.hpp>
+
+#include "TempPath.hpp"
+
+namespace kl::test {
+    using kl::fs::FileError;
+    using kl::fs::FileExtent;
+    using kl::fs::RangeWriter;
+    using kl::util::error::Result;
+
+    class RangeWriterTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fd = file.fd();
+            ASSERT_NE(fd, -1);
+
+            pattern.resize(4096);
+            std::iota(pattern.begin(), pattern.end(), std::uint8_t{0});
+        }
+
+        TempFile file;
+        std::vector<std::uint8_t> pattern;
+        int fd = -1;
+    };
+
+    TEST_F(RangeWriterTest, writeExtentsInRangesTest) {
+        const std::uintmax_t extentSize = 2 * RangeWriter::RANGE_SIZE + 1000;
+        const std::vector<FileExtent> extents = {{0, extentSize}, {extentSize + 8192, 5000}};
+
+        std::mutex mutex;
+        std::vector<FileExtent> completed;
+        RangeWriter writer(fd, 3);
+
+        auto result = writer.writeExtents(pattern.data(), pattern.size(), extents,
+                                          [&](std::uintmax_t offset, std::uintmax_t length) -> Result<void, FileError> {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back({offset, length});
+            return {};
+        });
+
+        ASSERT_FALSE(result.hasError());
+        EXPECT_EQ(result.value(), extentSize + 5000);
+        EXPECT_EQ(completed.size(), 4);
+
+        /* each range starts with pattern, as if extent was written sequentially */
+        for (const auto& [offset, length] : completed) {
+            const std::size_t size = std::min<std::size_t>(pattern.size(), length);
+            std::vector<std::uint8_t> data(size);
+
+            ASSERT_EQ(::pread(fd, data.data(), size, static_cast<off_t>(offset)), static_cast<ssize_t>(size));
+            EXPECT_TRUE(std::equal(data.begin(), data.end(), pattern.begin()));
+        }
+    }
+
+    TEST_F(RangeWriterTest, stopOnCompletionErrorTest) {
+        const std::vector<FileExtent> extents = {{0, 8 * RangeWriter::RANGE_SIZE}};
+        RangeWriter writer(fd, 1);
+        int countCalls = 0;
+
+        auto result = writer.writeExtents(pattern.data(), pattern.size(), extents,
+                                          [&](std::uintmax_t, std::uintmax_t) -> Result<void, FileError> {
+            ++countCalls;
+            return FileError("Cancelled");
+        });
+
+        ASSERT_TRUE(result.hasError());
+        EXPECT_EQ(countCalls, 1);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstdlib>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+namespace kl::test {
+
+    /* file with unique name in temp directory, removed on destruction */
+    class TempFile final {
+    public:
+        explicit TempFile(const std::string& prefix = "firearrow") {
+            std::string name = (std::filesystem::temp_directory_path() / (prefix + "_XXXXXX")).string();
+
+            fd_ = ::mkstemp(name.data());
+            if (fd_ != -1) {
+                path_ = name;
+            }
+        }
+
+        ~TempFile() {
+            if (fd_ != -1) {
+                ::close(fd_);
+            }
+
+            std::error_code error;
+            std::filesystem::remove(path_, error);
+        }
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        int fd() const { return fd_; }
+        const std::filesystem::path& path() const { return path_; }
+
+    private:
+        std::filesystem::path path_;
+        int fd_ = -1;
+    };
+
+    /* directory with unique name in temp directory, removed with its content on destruction */
+    class TempDirectory final {
+    public:
+        explicit TempDirectory(const std::string& prefix = "firearrow") {
+            std::string name = (std::filesystem::temp_directory_path() / (prefix + "_XXXXXX")).string();
+
+            if (::mkdtemp(name.data()) != nullptr) {
+                path_ = name;
+            }
+        }
+
+        ~TempDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(path_, error);
+        }
+
+        TempDirectory(const TempDirectory&) = delete;
+        TempDirectory& operator=(const TempDirectory&) = delete;
+
+        const std::filesystem::path& path() const { return path_; }
+
+    private:
+        std::filesystem::path path_;
+    };
+}
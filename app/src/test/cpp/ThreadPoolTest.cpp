@@ -0,0 +1,82 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <coroutine/FuturePromise.hpp>
+#include <coroutine/Task.hpp>
+#include <coroutine/ThreadPool.hpp>
+
+namespace kl::test {
+    using kl::coroutine::Task;
+    using kl::coroutine::ThreadPool;
+
+    static std::future<std::thread::id> resumeOnPool(ThreadPool& pool) {
+        co_await pool.schedule();
+        co_return std::this_thread::get_id();
+    }
+
+    static std::future<void> countOnPool(ThreadPool& pool, std::atomic<int>& counter) {
+        co_await pool.schedule();
+        counter.fetch_add(1);
+        co_return;
+    }
+
+    static std::future<Task<int>> executeTask(ThreadPool& pool) {
+        Task<int> task([&pool]() { return pool.isWorker() ? 1 : 0; }, &pool);
+        co_await task;
+        co_return task;
+    }
+
+    TEST(ThreadPoolTest, scheduleOnWorkerTest) {
+        ThreadPool pool(2);
+
+        EXPECT_FALSE(pool.isWorker());
+        EXPECT_NE(resumeOnPool(pool).get(), std::this_thread::get_id());
+
+        Task<int> task = executeTask(pool).get();
+
+        EXPECT_TRUE(task.finished.get());
+        EXPECT_EQ(task.value.get(), 1);
+    }
+
+    TEST(ThreadPoolTest, resumeAllPostedTest) {
+        constexpr int COUNT_COROUTINES = 1000;
+        std::atomic<int> counter = 0;
+        std::vector<std::future<void>> futures;
+
+        {
+            ThreadPool pool(4);
+
+            for (int i = 0; i < COUNT_COROUTINES; ++i) {
+                futures.push_back(countOnPool(pool, counter));
+            }
+        }
+
+        EXPECT_EQ(counter.load(), COUNT_COROUTINES);
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2022 https://github.com/klappdev
+ *
+ * Permission is hereby  granted, free of charge, to any  person obtaining a copy
+ * of this software and associated  documentation files (the "Software"), to deal
+ * in the Software  without restriction, including without  limitation the rights
+ * to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+ * copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+ * IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+ * FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+ * AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <coroutine/Lazy.hpp>
+#include <coroutine/Oneshot.hpp>
+#include <coroutine/ThreadPool.hpp>
+#include <coroutine/WhenAll.hpp>
+#include <coroutine/WhenAny.hpp>
+
+namespace kl::test {
+    using kl::coroutine::Lazy;
+    using kl::coroutine::Oneshot;
+    using kl::coroutine::ThreadPool;
+    using kl::coroutine::whenAll;
+    using kl::coroutine::whenAny;
+
+    static Lazy<int> square(int value) {
+        co_return value * value;
+    }
+
+    static Lazy<std::string> name() {
+        co_return std::string("lazy");
+    }
+
+    static Lazy<void> increment(std::atomic<int>& counter) {
+        counter.fetch_add(1);
+        co_return;
+    }
+
+    static Lazy<int> fail() {
+        throw std::runtime_error("lazy error");
+        co_return 0;
+    }
+
+    static Oneshot<int> sumSquares(ThreadPool* pool, int count) {
+        std::vector<Lazy<int>> lazies;
+
+        for (int i = 1; i <= count; ++i) {
+            lazies.push_back(square(i));
+        }
+
+        int sum = 0;
+
+        for (int value : co_await whenAll(pool, std::move(lazies))) {
+            sum += value;
+        }
+
+        co_return sum;
+    }
+
+    static Oneshot<std::tuple<int, std::string, std::monostate>> mixed(ThreadPool* pool, std::atomic<int>& counter) {
+        co_return co_await whenAll(pool, square(3), name(), increment(counter));
+    }
+
+    static Oneshot<int> failAll(ThreadPool* pool) {
+        auto [first, second] = co_await whenAll(pool, square(2), fail());
+        co_return first + second;
+    }
+
+    static Oneshot<std::size_t> firstSquare(ThreadPool* pool, int count) {
+        std::vector<Lazy<int>> lazies;
+
+        for (int i = 0; i < count; ++i) {
+            lazies.push_back(square(i));
+        }
+
+        auto [index, value] = co_await whenAny(pool, std::move(lazies));
+        co_return static_cast<int>(index * index) == value ? index : count;
+    }
+
+    TEST(WhenAllTest, inlineTest) {
+        std::atomic<int> counter = 0;
+        auto [value, text, none] = mixed(nullptr, counter).get();
+
+        EXPECT_EQ(value, 9);
+        EXPECT_EQ(text, "lazy");
+        EXPECT_EQ(counter.load(), 1);
+        EXPECT_EQ(sumSquares(nullptr, 10).get(), 385);
+        EXPECT_EQ(firstSquare(nullptr, 10).get(), 0);
+    }
+
+    TEST(WhenAllTest, poolTest) {
+        ThreadPool pool(4);
+        std::atomic<int> counter = 0;
+
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(sumSquares(&pool, 100).get(), 338350);
+            EXPECT_EQ(std::get<0>(mixed(&pool, counter).get()), 9);
+            EXPECT_LT(firstSquare(&pool, 16).get(), 16);
+        }
+
+        EXPECT_EQ(counter.load(), 100);
+    }
+
+    TEST(WhenAllTest, exceptionTest) {
+        ThreadPool pool(2);
+
+        EXPECT_THROW(failAll(nullptr).get(), std::runtime_error);
+        EXPECT_THROW(failAll(&pool).get(), std::runtime_error);
+    }
+}